@@ -0,0 +1,230 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "api/api_dialogs_snapshot.h"
+
+#include "data/data_histories.h"
+#include "data/data_peer_id.h"
+#include "data/data_session.h"
+#include "history/history.h"
+#include "history/history_item.h"
+#include "main/main_session.h"
+#include "storage/storage_account.h"
+#include "apiwrap.h"
+
+namespace Api {
+namespace {
+
+// The first two pages of the main list are enough for the cold start.
+constexpr auto kMaxDialogs = 1024;
+
+[[nodiscard]] QByteArray Serialize(const MTPmessages_Dialogs &dialogs) {
+	auto buffer = mtpBuffer();
+	buffer.push_back(mtpPrime(AppVersion));
+	dialogs.write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+[[nodiscard]] std::optional<MTPmessages_Dialogs> Deserialize(
+		const QByteArray &serialized) {
+	if (serialized.isEmpty() || (serialized.size() % sizeof(mtpPrime))) {
+		return std::nullopt;
+	}
+	auto buffer = mtpBuffer(serialized.size() / sizeof(mtpPrime));
+	memcpy(buffer.data(), serialized.constData(), serialized.size());
+
+	// The scheme may change between versions, drop the old snapshots.
+	auto from = buffer.constData();
+	const auto till = from + buffer.size();
+	if (*from++ != mtpPrime(AppVersion)) {
+		return std::nullopt;
+	}
+	auto result = MTPmessages_Dialogs();
+	if (!result.read(from, till) || from != till) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+} // namespace
+
+DialogsSnapshot::DialogsSnapshot(not_null<ApiWrap*> api)
+: _session(&api->session()) {
+}
+
+DialogsSnapshot::~DialogsSnapshot() = default;
+
+void DialogsSnapshot::apply() {
+	if (_applied) {
+		return;
+	}
+	_applied = true;
+
+	const auto started = crl::now();
+	const auto serialized = _session->local().readDialogsSnapshot();
+	if (serialized.isEmpty()) {
+		return;
+	}
+	const auto parsed = Deserialize(serialized);
+	if (!parsed) {
+		DEBUG_LOG(("Dialogs Snapshot: Could not read %1 bytes."
+			).arg(serialized.size()));
+		return;
+	}
+	auto &owner = _session->data();
+	parsed->match([&](const MTPDmessages_dialogsNotModified &) {
+	}, [&](const auto &data) {
+		owner.processUsers(data.vusers());
+		owner.processChats(data.vchats());
+		for (const auto &message : data.vmessages().v) {
+			_unconfirmedItems.emplace(
+				PeerFromMessage(message),
+				IdFromMessage(message));
+		}
+		owner.applyDialogs(
+			nullptr,
+			data.vmessages().v,
+			data.vdialogs().v);
+		for (const auto &dialog : data.vdialogs().v) {
+			dialog.match([&](const MTPDdialog &data) {
+				if (const auto peerId = peerFromMTP(data.vpeer())) {
+					_unconfirmed.emplace(owner.history(peerId));
+				}
+			}, [](const MTPDdialogFolder &) {
+			});
+		}
+	});
+	owner.chatsListChanged(static_cast<Data::Folder*>(nullptr));
+
+	DEBUG_LOG(("Dialogs Snapshot: Applied %1 chats in %2 ms."
+		).arg(_unconfirmed.size()
+		).arg(crl::now() - started));
+}
+
+void DialogsSnapshot::received(const MTPmessages_Dialogs &result) {
+	result.match([](const MTPDmessages_dialogsNotModified &) {
+	}, [&](const auto &data) {
+		received(
+			data.vdialogs().v,
+			data.vmessages().v,
+			data.vchats().v,
+			data.vusers().v);
+	});
+}
+
+void DialogsSnapshot::received(const MTPmessages_PeerDialogs &result) {
+	result.match([&](const MTPDmessages_peerDialogs &data) {
+		received(
+			data.vdialogs().v,
+			data.vmessages().v,
+			data.vchats().v,
+			data.vusers().v);
+	});
+}
+
+void DialogsSnapshot::received(
+		const QVector<MTPDialog> &dialogs,
+		const QVector<MTPMessage> &messages,
+		const QVector<MTPChat> &chats,
+		const QVector<MTPUser> &users) {
+	_applied = true;
+	if (_finished) {
+		return;
+	}
+	for (const auto &message : messages) {
+		_unconfirmedItems.remove(FullMsgId(
+			PeerFromMessage(message),
+			IdFromMessage(message)));
+	}
+	const auto full = (_dialogs.size() >= kMaxDialogs);
+	const auto room = [&] {
+		return (_dialogs.size() < kMaxDialogs);
+	};
+	for (const auto &dialog : dialogs) {
+		dialog.match([&](const MTPDdialog &data) {
+			if (const auto peerId = peerFromMTP(data.vpeer())) {
+				if (const auto history = _session->data().historyLoaded(
+						peerId)) {
+					_unconfirmed.remove(history);
+				}
+				// Pinned dialogs may be received more than once.
+				if (room() && _dialogPeers.emplace(peerId).second) {
+					_dialogs.push_back(dialog);
+				}
+			}
+		}, [&](const MTPDdialogFolder &data) {
+			const auto folderId = data.vfolder().data().vid().v;
+			if (room() && _dialogFolders.emplace(folderId).second) {
+				_dialogs.push_back(dialog);
+			}
+		});
+	}
+	if (full) {
+		return;
+	}
+	for (const auto &message : messages) {
+		const auto id = FullMsgId(
+			PeerFromMessage(message),
+			IdFromMessage(message));
+		if (_messageIds.emplace(id).second) {
+			_messages.push_back(message);
+		}
+	}
+	_chats.append(chats);
+	_users.append(users);
+}
+
+void DialogsSnapshot::finished() {
+	if (_finished) {
+		return;
+	}
+	_finished = true;
+	write();
+	destroyUnconfirmedItems();
+
+	// Chats that were deleted, left or archived while we were offline.
+	auto &histories = _session->data().histories();
+	for (const auto &history : base::take(_unconfirmed)) {
+		histories.requestDialogEntry(history);
+	}
+}
+
+void DialogsSnapshot::destroyUnconfirmedItems() {
+	// Messages from the saved list that the server didn't send again
+	// may be deleted or edited already, don't keep them around. Those
+	// that were loaded with the history since then have views.
+	auto &owner = _session->data();
+	auto destroyed = 0;
+	for (const auto &id : base::take(_unconfirmedItems)) {
+		if (const auto item = owner.message(id)) {
+			if (!item->mainView()) {
+				item->destroy();
+				++destroyed;
+			}
+		}
+	}
+	if (destroyed > 0) {
+		DEBUG_LOG(("Dialogs Snapshot: Destroyed %1 unconfirmed messages."
+			).arg(destroyed));
+	}
+}
+
+void DialogsSnapshot::write() {
+	const auto serialized = Serialize(MTP_messages_dialogs(
+		MTP_vector<MTPDialog>(base::take(_dialogs)),
+		MTP_vector<MTPMessage>(base::take(_messages)),
+		MTP_vector<MTPChat>(base::take(_chats)),
+		MTP_vector<MTPUser>(base::take(_users))));
+	_session->local().writeDialogsSnapshot(serialized);
+	_dialogPeers.clear();
+	_dialogFolders.clear();
+	_messageIds.clear();
+}
+
+} // namespace Api
@@ -0,0 +1,60 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class ApiWrap;
+class History;
+
+namespace Main {
+class Session;
+} // namespace Main
+
+namespace Api {
+
+// Locally saved copy of the main chats list as it was received from the
+// server, so that the list is shown right away on start and then
+// reconciled with the messages.getDialogs results. Saved messages that
+// the server didn't send again are destroyed when the list is loaded.
+class DialogsSnapshot final {
+public:
+	explicit DialogsSnapshot(not_null<ApiWrap*> api);
+	~DialogsSnapshot();
+
+	// Applies the saved list, only once and before any server data.
+	void apply();
+
+	void received(const MTPmessages_Dialogs &result);
+	void received(const MTPmessages_PeerDialogs &result);
+	void finished();
+
+private:
+	void received(
+		const QVector<MTPDialog> &dialogs,
+		const QVector<MTPMessage> &messages,
+		const QVector<MTPChat> &chats,
+		const QVector<MTPUser> &users);
+	void write();
+	void destroyUnconfirmedItems();
+
+	const not_null<Main::Session*> _session;
+
+	QVector<MTPDialog> _dialogs;
+	QVector<MTPMessage> _messages;
+	QVector<MTPChat> _chats;
+	QVector<MTPUser> _users;
+	base::flat_set<PeerId> _dialogPeers;
+	base::flat_set<int> _dialogFolders;
+	base::flat_set<FullMsgId> _messageIds;
+	base::flat_set<not_null<History*>> _unconfirmed;
+	base::flat_set<FullMsgId> _unconfirmedItems;
+	bool _applied = false;
+	bool _finished = false;
+
+};
+
+} // namespace Api
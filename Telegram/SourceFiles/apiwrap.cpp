@@ -34,6 +34,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_premium.h"
 #include "api/api_user_names.h"
 #include "api/api_websites.h"
+#include "api/api_dialogs_snapshot.h"
 #include "data/business/data_shortcut_messages.h"
 #include "data/components/scheduled_messages.h"
 #include "data/notify/data_notify_settings.h"
@@ -177,7 +178,8 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 , _premium(std::make_unique<Api::Premium>(this))
 , _usernames(std::make_unique<Api::Usernames>(this))
 , _websites(std::make_unique<Api::Websites>(this))
-, _peerColors(std::make_unique<Api::PeerColors>(this)) {
+, _peerColors(std::make_unique<Api::PeerColors>(this))
+, _dialogsSnapshot(std::make_unique<Api::DialogsSnapshot>(this)) {
 	crl::on_main(session, [=] {
 		// You can't use _session->lifetime() in the constructor,
 		// only queued, because it is not constructed yet.
@@ -862,6 +864,8 @@ void ApiWrap::requestContacts() {
 void ApiWrap::requestDialogs(Data::Folder *folder) {
 	if (folder && !_foldersLoadState.contains(folder)) {
 		_foldersLoadState.emplace(folder, DialogsLoadState());
+	} else if (!folder) {
+		_dialogsSnapshot->apply();
 	}
 	requestMoreDialogs(folder);
 }
@@ -892,6 +896,9 @@ void ApiWrap::requestMoreDialogs(Data::Folder *folder) {
 		MTP_int(loadCount),
 		MTP_long(hash)
 	)).done([=](const MTPmessages_Dialogs &result) {
+		if (!folder) {
+			_dialogsSnapshot->received(result);
+		}
 		const auto state = dialogsLoadState(folder);
 		const auto count = result.match([](
 				const MTPDmessages_dialogsNotModified &) {
@@ -1042,6 +1049,7 @@ void ApiWrap::dialogsLoadFinish(Data::Folder *folder) {
 		notify();
 	} else {
 		_dialogsLoadState = nullptr;
+		_dialogsSnapshot->finished();
 		notify();
 	}
 }
@@ -1062,6 +1070,9 @@ void ApiWrap::requestPinnedDialogs(Data::Folder *folder) {
 	state->pinnedRequestId = request(MTPmessages_GetPinnedDialogs(
 		MTP_int(folder ? folder->id() : 0)
 	)).done([=](const MTPmessages_PeerDialogs &result) {
+		if (!folder) {
+			_dialogsSnapshot->received(result);
+		}
 		finalize();
 		result.match([&](const MTPDmessages_peerDialogs &data) {
 			_session->data().processUsers(data.vusers());
@@ -84,6 +84,7 @@ class Transcribes;
 class Premium;
 class Usernames;
 class Websites;
+class DialogsSnapshot;
 
 namespace details {
 
@@ -769,6 +770,7 @@ private:
 	const std::unique_ptr<Api::Usernames> _usernames;
 	const std::unique_ptr<Api::Websites> _websites;
 	const std::unique_ptr<Api::PeerColors> _peerColors;
+	const std::unique_ptr<Api::DialogsSnapshot> _dialogsSnapshot;
 
 	mtpRequestId _wallPaperRequestId = 0;
 	QString _wallPaperSlug;
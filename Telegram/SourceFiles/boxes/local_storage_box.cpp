@@ -17,6 +17,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/format_values.h"
 #include "ui/emoji_config.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_deduplicator.h"
+#include "storage/storage_cache_policy.h"
 #include "storage/cache/storage_cache_database.h"
 #include "data/data_session.h"
 #include "lang/lang_keys.h"
@@ -128,7 +130,7 @@ public:
 		rpl::producer<QString> clear,
 		const Database::TaggedSummary &data);
 
-	void update(const Database::TaggedSummary &data);
+	void update(const Database::TaggedSummary &data, int hitPercent = -1);
 	void toggleProgress(bool shown);
 
 	rpl::producer<> clearRequests() const;
@@ -148,6 +150,7 @@ private:
 	object_ptr<Ui::FlatLabel> _clearing = { nullptr };
 	object_ptr<Ui::RoundButton> _clear;
 	std::unique_ptr<Ui::InfiniteRadialAnimation> _progress;
+	int _hitPercent = -1;
 
 };
 
@@ -171,7 +174,10 @@ LocalStorageBox::Row::Row(
 	_clear->setVisible(data.count != 0);
 }
 
-void LocalStorageBox::Row::update(const Database::TaggedSummary &data) {
+void LocalStorageBox::Row::update(
+		const Database::TaggedSummary &data,
+		int hitPercent) {
+	_hitPercent = hitPercent;
 	if (data.count != 0) {
 		_title->setText(titleText(data));
 	}
@@ -262,9 +268,18 @@ QString LocalStorageBox::Row::titleText(const Database::TaggedSummary &data) con
 }
 
 QString LocalStorageBox::Row::sizeText(const Database::TaggedSummary &data) const {
-	return data.totalSize
-		? Ui::FormatSizeText(data.totalSize)
-		: tr::lng_local_storage_empty(tr::now);
+	if (!data.totalSize) {
+		return tr::lng_local_storage_empty(tr::now);
+	}
+	const auto size = Ui::FormatSizeText(data.totalSize);
+	return (_hitPercent >= 0)
+		? tr::lng_local_storage_hit_ratio(
+			tr::now,
+			lt_size,
+			size,
+			lt_percent,
+			QString::number(_hitPercent))
+		: size;
 }
 
 LocalStorageBox::LocalStorageBox(
@@ -308,11 +323,12 @@ void LocalStorageBox::prepare() {
 
 void LocalStorageBox::updateRow(
 		not_null<Ui::SlideWrap<Row>*> row,
-		const Database::TaggedSummary *data) {
+		const Database::TaggedSummary *data,
+		int hitPercent) {
 	const auto summary = (_rows.find(0)->second == row);
 	const auto shown = (data && data->count && data->totalSize) || summary;
 	if (shown) {
-		row->entity()->update(*data);
+		row->entity()->update(*data, hitPercent);
 	}
 	row->toggle(shown, anim::type::normal);
 }
@@ -333,7 +349,8 @@ void LocalStorageBox::update(
 			const auto i = _stats.tagged.find(entry.first);
 			updateRow(
 				entry.second,
-				(i != end(_stats.tagged)) ? &i->second : nullptr);
+				(i != end(_stats.tagged)) ? &i->second : nullptr,
+				hitPercent(entry.first));
 		} else {
 			const auto full = summary();
 			updateRow(entry.second, &full);
@@ -341,6 +358,12 @@ void LocalStorageBox::update(
 	}
 }
 
+int LocalStorageBox::hitPercent(uint16 tag) const {
+	const auto stats = _session->data().cachePolicy().tagStats(tag);
+	const auto total = stats.hits + stats.misses;
+	return total ? int(stats.hits * 100 / total) : -1;
+}
+
 auto LocalStorageBox::summary() const -> Database::TaggedSummary {
 	auto result = _stats.full;
 	result.count += _statsBig.full.count;
@@ -394,11 +417,13 @@ void LocalStorageBox::setupControls() {
 		auto title = [factory = std::move(factory)](size_type count) {
 			return factory(tr::now, lt_count, count);
 		};
-		tracker.track(createRow(
+		const auto row = createRow(
 			tag,
 			std::move(title),
 			tr::lng_local_storage_clear_some(),
-			data));
+			data);
+		row->entity()->update(data, hitPercent(tag));
+		tracker.track(row);
 	};
 	auto summaryTitle = [](size_type) {
 		return tr::lng_local_storage_summary(tr::now);
@@ -412,6 +437,7 @@ void LocalStorageBox::setupControls() {
 		tr::lng_local_storage_clear(),
 		summary());
 	setupLimits(container);
+	setupDeduplicated(container);
 	const auto shadow = container->add(object_ptr<Ui::SlideWrap<>>(
 		container,
 		object_ptr<Ui::PlainShadow>(container),
@@ -436,6 +462,32 @@ void LocalStorageBox::setupControls() {
 	}, container->lifetime());
 }
 
+void LocalStorageBox::setupDeduplicated(
+		not_null<Ui::VerticalLayout*> container) {
+	const auto wrap = container->add(
+		object_ptr<Ui::SlideWrap<Ui::LabelSimple>>(
+			container,
+			object_ptr<Ui::LabelSimple>(
+				container,
+				st::localStorageLimitLabel),
+			st::localStorageLimitLabelMargin));
+	const auto label = wrap->entity();
+	auto saved = _session->data().cacheDeduplicator().savedBytesValue();
+	rpl::duplicate(
+		saved
+	) | rpl::start_with_next([=](int64 bytes) {
+		label->setText(tr::lng_local_storage_deduplicated(
+			tr::now,
+			lt_size,
+			Ui::FormatSizeText(bytes)));
+	}, label->lifetime());
+	wrap->toggleOn(std::move(
+		saved
+	) | rpl::map([](int64 bytes) {
+		return bytes > 0;
+	}), anim::type::instant);
+}
+
 template <
 	typename Value,
 	typename Convert,
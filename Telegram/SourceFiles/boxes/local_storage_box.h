@@ -56,9 +56,11 @@ private:
 	void update(Database::Stats &&stats, Database::Stats &&statsBig);
 	void updateRow(
 		not_null<Ui::SlideWrap<Row>*> row,
-		const Database::TaggedSummary *data);
+		const Database::TaggedSummary *data,
+		int hitPercent = -1);
 	void setupControls();
 	void setupLimits(not_null<Ui::VerticalLayout*> container);
+	void setupDeduplicated(not_null<Ui::VerticalLayout*> container);
 	void updateMediaLimit();
 	void updateTotalLimit();
 	void updateTotalLabel();
@@ -67,6 +69,7 @@ private:
 	void save();
 
 	Database::TaggedSummary summary() const;
+	int hitPercent(uint16 tag) const;
 
 	template <
 		typename Value,
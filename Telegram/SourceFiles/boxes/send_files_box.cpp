@@ -68,6 +68,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kMaxMessageLength = 4096;
+constexpr auto kMaxPreparingFiles = 4;
 
 using Ui::SendFilesWay;
 
@@ -548,31 +549,40 @@ void SendFilesBox::initPreview() {
 }
 
 void SendFilesBox::enqueueNextPrepare() {
-	if (_preparing) {
-		return;
-	}
-	while (!_list.filesToProcess.empty()
-		&& _list.filesToProcess.front().information) {
+	// Each prepared file holds a full decoded image until it is sent,
+	// so we limit the amount of them being prepared at the same time.
+	const auto limit = std::clamp(
+		QThread::idealThreadCount(),
+		1,
+		kMaxPreparingFiles);
+	const auto weak = Ui::MakeWeak(this);
+	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
+	while (!_list.filesToProcess.empty() && _preparingAsync < limit) {
 		auto file = std::move(_list.filesToProcess.front());
 		_list.filesToProcess.pop_front();
-		addFile(std::move(file));
+		const auto id = ++_preparingLastId;
+		if (file.information) {
+			_preparing.push_back({ .id = id, .file = std::move(file) });
+			continue;
+		}
+		_preparing.push_back({ .id = id });
+		++_preparingAsync;
+		crl::async([=, file = std::move(file)]() mutable {
+			Storage::PrepareDetails(file, st::sendMediaPreviewSize, sideLimit);
+			crl::on_main([=, file = std::move(file)]() mutable {
+				if (weak) {
+					weak->addPreparedAsyncFile(id, std::move(file));
+				}
+			});
+		});
 	}
-	if (_list.filesToProcess.empty()) {
-		return;
+
+	// Files are added in the original order as soon as they're ready.
+	while (!_preparing.empty() && _preparing.front().file) {
+		auto file = std::move(*_preparing.front().file);
+		_preparing.pop_front();
+		addFile(std::move(file));
 	}
-	auto file = std::move(_list.filesToProcess.front());
-	_list.filesToProcess.pop_front();
-	const auto weak = Ui::MakeWeak(this);
-	_preparing = true;
-	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
-	crl::async([weak, sideLimit, file = std::move(file)]() mutable {
-		Storage::PrepareDetails(file, st::sendMediaPreviewSize, sideLimit);
-		crl::on_main([weak, file = std::move(file)]() mutable {
-			if (weak) {
-				weak->addPreparedAsyncFile(std::move(file));
-			}
-		});
-	});
 }
 
 void SendFilesBox::prepare() {
@@ -1551,17 +1561,22 @@ bool SendFilesBox::addFiles(Ui::PreparedList list) {
 	return true;
 }
 
-void SendFilesBox::addPreparedAsyncFile(Ui::PreparedFile &&file) {
+void SendFilesBox::addPreparedAsyncFile(
+		uint64 id,
+		Ui::PreparedFile &&file) {
 	Expects(file.information != nullptr);
 
-	_preparing = false;
+	const auto i = ranges::find(_preparing, id, &PreparingFile::id);
+	Assert(i != end(_preparing));
+	i->file = std::move(file);
+	--_preparingAsync;
+
 	const auto count = int(_list.files.size());
-	addFile(std::move(file));
 	enqueueNextPrepare();
 	if (_list.files.size() > count) {
 		refreshAllAfterChanges(count);
 	}
-	if (!_preparing && _whenReadySend) {
+	if (_preparing.empty() && _whenReadySend) {
 		_whenReadySend();
 	}
 }
@@ -1767,7 +1782,7 @@ void SendFilesBox::send(
 			{ .type = SendMenu::ActionType::Schedule },
 			child);
 	}
-	if (_preparing) {
+	if (!_preparing.empty()) {
 		_whenReadySend = [=] {
 			send(options, ctrlShiftEnter);
 		};
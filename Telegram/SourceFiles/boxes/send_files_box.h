@@ -238,8 +238,13 @@ private:
 	void openDialogToAddFileToAlbum();
 	void refreshAllAfterChanges(int fromItem, Fn<void()> perform = nullptr);
 
+	struct PreparingFile {
+		uint64 id = 0;
+		std::optional<Ui::PreparedFile> file;
+	};
+
 	void enqueueNextPrepare();
-	void addPreparedAsyncFile(Ui::PreparedFile &&file);
+	void addPreparedAsyncFile(uint64 id, Ui::PreparedFile &&file);
 
 	void checkCharsLimitation();
 
@@ -294,7 +299,9 @@ private:
 	QPointer<Ui::VerticalLayout> _inner;
 	std::vector<Block> _blocks;
 	Fn<void()> _whenReadySend;
-	bool _preparing = false;
+	std::deque<PreparingFile> _preparing;
+	uint64 _preparingLastId = 0;
+	int _preparingAsync = 0;
 
 	base::unique_qptr<Ui::PopupMenu> _menu;
 
@@ -902,6 +902,11 @@ StickerSetBox::Inner::Inner(
 , _previewTimer([=] { showPreview(); }) {
 	setAttribute(Qt::WA_OpaquePaintEvent);
 
+	// Let the server result be merged with the real local stickers.
+	if (_setId) {
+		_session->local().readPendingStickerSet(_setId);
+	}
+
 	_api.request(MTPmessages_GetStickerSet(
 		Data::InputStickerSet(_input),
 		MTP_int(0) // hash
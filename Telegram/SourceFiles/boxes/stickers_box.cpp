@@ -495,7 +495,9 @@ void StickersBox::showAttachedStickers() {
 	const auto add = [&](not_null<StickersSet*> set) {
 		if (_attached.widget()->appendSet(set)) {
 			addedSet = true;
-			if (set->stickers.isEmpty()
+			const auto pending = session().local().hasPendingStickerSet(
+				set->id);
+			if ((set->stickers.isEmpty() && !pending)
 				|| (set->flags & SetFlag::NotLoaded)) {
 				session().api().scheduleStickerSetRequest(
 					set->id,
@@ -1007,6 +1009,7 @@ void StickersBox::requestArchivedSets() {
 		if (it != sets.cend()) {
 			const auto set = it->second.get();
 			if (set->stickers.isEmpty()
+				&& !session().local().hasPendingStickerSet(setId)
 				&& (set->flags & SetFlag::NotLoaded)) {
 				session().api().scheduleStickerSetRequest(
 					setId,
@@ -2481,6 +2484,8 @@ int StickersBox::Inner::countMaxNameWidth(bool installedSet) const {
 }
 
 void StickersBox::Inner::rebuildAppendSet(not_null<StickersSet*> set) {
+	session().local().readPendingStickerSet(set->id);
+
 	auto flagsOverride = (set->id != Data::Stickers::CloudRecentSetId)
 		? fillSetFlags(set)
 		: SetFlag::Installed;
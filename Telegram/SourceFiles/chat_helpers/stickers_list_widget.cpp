@@ -65,6 +65,10 @@ constexpr auto kPreloadOfficialPages = 4;
 constexpr auto kOfficialLoadLimit = 40;
 constexpr auto kMinRepaintDelay = crl::time(33);
 constexpr auto kMinAfterScrollDelay = crl::time(33);
+constexpr auto kMaxPlayingStickers = 48;
+
+// Keep players of that many sets scrolled away, with their saved frames.
+constexpr auto kParkedLottieSets = 4;
 
 using Data::StickersSet;
 using Data::StickersPack;
@@ -85,6 +89,8 @@ struct StickersListWidget::Sticker {
 	QImage savedFrame;
 	QSize savedFrameFor;
 	QImage premiumLock;
+	crl::time lottieRequested = 0;
+	bool lottieOverLimit = false;
 
 	void ensureMediaCreated();
 };
@@ -120,6 +126,16 @@ struct StickersListWidget::Set {
 	bool externalLayout = false;
 };
 
+struct StickersListWidget::ParkedLottie {
+	uint64 setId = 0;
+	QSize box;
+	std::unique_ptr<Lottie::MultiPlayer> player;
+	rpl::lifetime lifetime;
+	base::flat_map<
+		not_null<DocumentData*>,
+		not_null<Lottie::Animation*>> animations;
+};
+
 auto StickersListWidget::PrepareStickers(
 	const QVector<DocumentData*> &pack,
 	bool skipPremium)
@@ -835,6 +851,7 @@ void StickersListWidget::takeHeavyData(Sticker &to, Sticker &from) {
 	to.savedFrame = std::move(from.savedFrame);
 	to.savedFrameFor = from.savedFrameFor;
 	to.lottie = base::take(from.lottie);
+	to.lottieRequested = base::take(from.lottieRequested);
 	to.webm = base::take(from.webm);
 }
 
@@ -1145,11 +1162,17 @@ void StickersListWidget::checkVisibleLottie() {
 	const auto destroyAfterDistance = (visibleBottom - visibleTop) * 2;
 	const auto destroyAbove = visibleTop - destroyAfterDistance;
 	const auto destroyBelow = visibleBottom + destroyAfterDistance;
+	auto playing = 0;
 	enumerateSections([&](const SectionInfo &info) {
 		if (destroyBelow <= info.rowsTop
 			|| destroyAbove >= info.rowsBottom) {
-			clearHeavyIn(shownSets()[info.section]);
-		} else if ((visibleTop > info.rowsTop && visibleTop < info.rowsBottom)
+			parkHeavyIn(shownSets()[info.section]);
+			return true;
+		}
+		if (visibleBottom > info.rowsTop && visibleTop < info.rowsBottom) {
+			limitPlayingLottieIn(info, playing);
+		}
+		if ((visibleTop > info.rowsTop && visibleTop < info.rowsBottom)
 			|| (visibleBottom > info.rowsTop
 				&& visibleBottom < info.rowsBottom)) {
 			pauseInvisibleLottieIn(info);
@@ -1158,6 +1181,39 @@ void StickersListWidget::checkVisibleLottie() {
 	});
 }
 
+void StickersListWidget::limitPlayingLottieIn(
+		const SectionInfo &info,
+		int &playing) {
+	// Only the first kMaxPlayingStickers visible animations are played,
+	// counted top to bottom, so the same ones play in every paint.
+	auto &set = shownSets()[info.section];
+	const auto player = set.lottiePlayer.get();
+	const auto rowHeight = _singleSize.height();
+	if (rowHeight <= 0) {
+		return;
+	}
+	const auto fromRow = std::clamp(
+		(getVisibleTop() - info.rowsTop) / rowHeight,
+		0,
+		info.rowsCount);
+	const auto tillRow = std::clamp(
+		(getVisibleBottom() - info.rowsTop + rowHeight - 1) / rowHeight,
+		fromRow,
+		info.rowsCount);
+	const auto till = std::min(tillRow * _columnCount, info.count);
+	for (auto index = fromRow * _columnCount; index < till; ++index) {
+		auto &sticker = set.stickers[index];
+		const auto data = sticker.document->sticker();
+		if (!data || !data->isLottie()) {
+			continue;
+		}
+		sticker.lottieOverLimit = (++playing > kMaxPlayingStickers);
+		if (sticker.lottieOverLimit && player && sticker.lottie) {
+			player->pause(sticker.lottie);
+		}
+	}
+}
+
 void StickersListWidget::clearHeavyIn(Set &set, bool clearSavedFrames) {
 	const auto player = base::take(set.lottiePlayer);
 	const auto lifetime = base::take(set.lottieLifetime);
@@ -1172,6 +1228,70 @@ void StickersListWidget::clearHeavyIn(Set &set, bool clearSavedFrames) {
 	}
 }
 
+void StickersListWidget::parkHeavyIn(Set &set) {
+	if (!set.lottiePlayer) {
+		const auto parked = ranges::contains(
+			_parkedLottie,
+			set.id,
+			&ParkedLottie::setId);
+		clearHeavyIn(set, !parked);
+		return;
+	}
+	auto parked = ParkedLottie{
+		.setId = set.id,
+		.box = boundingBoxSize(),
+		.player = base::take(set.lottiePlayer),
+		.lifetime = base::take(set.lottieLifetime),
+	};
+	for (const auto &sticker : set.stickers) {
+		if (const auto lottie = sticker.lottie) {
+			parked.player->pause(lottie);
+			parked.animations.emplace(sticker.document, lottie);
+		}
+	}
+	clearHeavyIn(set, false);
+	_parkedLottie.insert(begin(_parkedLottie), std::move(parked));
+	if (_parkedLottie.size() <= kParkedLottieSets) {
+		return;
+	}
+	const auto evictedId = _parkedLottie.back().setId;
+	_parkedLottie.pop_back();
+	for (auto &evicted : shownSets()) {
+		if (evicted.id == evictedId && !evicted.lottiePlayer) {
+			for (auto &sticker : evicted.stickers) {
+				sticker.savedFrame = QImage();
+				sticker.savedFrameFor = QSize();
+			}
+		}
+	}
+}
+
+bool StickersListWidget::restoreParkedLottie(Set &set) {
+	const auto i = ranges::find(_parkedLottie, set.id, &ParkedLottie::setId);
+	if (i == end(_parkedLottie)) {
+		return false;
+	}
+	auto parked = std::move(*i);
+	_parkedLottie.erase(i);
+	if (parked.box != boundingBoxSize()) {
+		return false;
+	}
+	set.lottiePlayer = std::move(parked.player);
+	set.lottieLifetime = std::move(parked.lifetime);
+	for (auto &sticker : set.stickers) {
+		const auto j = parked.animations.find(sticker.document);
+		if (j != end(parked.animations)) {
+			sticker.lottie = j->second;
+			parked.animations.erase(j);
+			++_lottieRestoredCount;
+		}
+	}
+	for (const auto &[document, animation] : parked.animations) {
+		set.lottiePlayer->remove(animation);
+	}
+	return true;
+}
+
 void StickersListWidget::pauseInvisibleLottieIn(const SectionInfo &info) {
 	auto &set = shownSets()[info.section];
 	const auto player = set.lottiePlayer.get();
@@ -1247,7 +1367,7 @@ void StickersListWidget::paintMegagroupEmptySet(Painter &p, int y, bool buttonSe
 }
 
 void StickersListWidget::ensureLottiePlayer(Set &set) {
-	if (set.lottiePlayer) {
+	if (set.lottiePlayer || restoreParkedLottie(set)) {
 		return;
 	}
 	set.lottiePlayer = std::make_unique<Lottie::MultiPlayer>(
@@ -1271,6 +1391,10 @@ void StickersListWidget::ensureLottiePlayer(Set &set) {
 void StickersListWidget::setupLottie(Set &set, int section, int index) {
 	auto &sticker = set.stickers[index];
 	ensureLottiePlayer(set);
+	if (sticker.lottie) {
+		// Restored from a parked player.
+		return;
+	}
 
 	// Document should be loaded already for the animation to be set up.
 	Assert(sticker.documentMedia != nullptr);
@@ -1279,6 +1403,8 @@ void StickersListWidget::setupLottie(Set &set, int section, int index) {
 		sticker.documentMedia.get(),
 		StickerLottieSize::StickersPanel,
 		boundingBoxSize() * style::DevicePixelRatio());
+	sticker.lottieRequested = crl::now();
+	++_lottieCreatedCount;
 }
 
 void StickersListWidget::setupWebm(Set &set, int section, int index) {
@@ -1486,7 +1612,14 @@ void StickersListWidget::paintSticker(
 			sticker.savedFrame.setDevicePixelRatio(style::DevicePixelRatio());
 			sticker.savedFrameFor = _singleSize;
 		}
-		set.lottiePlayer->unpause(sticker.lottie);
+		if (const auto requested = base::take(sticker.lottieRequested)) {
+			_lottieReadyDuration += now - requested;
+		}
+		if (!sticker.lottieOverLimit) {
+			set.lottiePlayer->unpause(sticker.lottie);
+		} else {
+			set.lottiePlayer->pause(sticker.lottie);
+		}
 	} else if (sticker.webm && sticker.webm->started()) {
 		const auto frame = sticker.webm->current(
 			{ .frame = size, .keepAlpha = true },
@@ -2056,6 +2189,19 @@ void StickersListWidget::clearHeavyData() {
 	for (auto &set : shownSets()) {
 		clearHeavyIn(set, false);
 	}
+	_parkedLottie.clear();
+	if (_lottieCreatedCount || _lottieRestoredCount) {
+		DEBUG_LOG(("Stickers Panel: "
+			"%1 animations created, %2 ms until ready on average, "
+			"%3 restored from parked players."
+			).arg(_lottieCreatedCount
+			).arg(_lottieCreatedCount
+				? (_lottieReadyDuration / _lottieCreatedCount)
+				: 0
+			).arg(_lottieRestoredCount));
+		_lottieCreatedCount = _lottieRestoredCount = 0;
+		_lottieReadyDuration = 0;
+	}
 }
 
 void StickersListWidget::refreshStickers() {
@@ -2204,6 +2350,8 @@ bool StickersListWidget::appendSet(
 		uint64 setId,
 		bool externalLayout,
 		AppendSkip skip) {
+	session().local().readPendingStickerSet(setId);
+
 	const auto &sets = session().data().stickers().sets();
 	auto it = sets.find(setId);
 	if (it == sets.cend()
@@ -154,6 +154,7 @@ protected:
 private:
 	struct Sticker;
 	struct Set;
+	struct ParkedLottie;
 
 	enum class Section {
 		Featured,
@@ -300,11 +301,14 @@ private:
 	void markLottieFrameShown(Set &set);
 	void checkVisibleLottie();
 	void pauseInvisibleLottieIn(const SectionInfo &info);
+	void limitPlayingLottieIn(const SectionInfo &info, int &playing);
 	void takeHeavyData(std::vector<Set> &to, std::vector<Set> &from);
 	void takeHeavyData(Set &to, Set &from);
 	void takeHeavyData(Sticker &to, Sticker &from);
 	void clearHeavyIn(Set &set, bool clearSavedFrames = true);
 	void clearHeavyData();
+	void parkHeavyIn(Set &set);
+	bool restoreParkedLottie(Set &set);
 	void updateItems();
 	void updateSets();
 	void repaintItems(crl::time now = 0);
@@ -390,6 +394,10 @@ private:
 	std::vector<EmojiPtr> _cornerEmoji;
 	base::flat_set<not_null<DocumentData*>> _favedStickersMap;
 	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
+	std::vector<ParkedLottie> _parkedLottie;
+	int _lottieCreatedCount = 0;
+	int _lottieRestoredCount = 0;
+	crl::time _lottieReadyDuration = 0;
 
 	bool _paintAsPremium = false;
 	bool _showingSetById = false;
@@ -12,6 +12,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_message_reactions.h"
 #include "data/data_session.h"
 #include "data/data_download_manager.h"
+#include "data/data_decoded_image_cache.h"
+#include "data/stickers/data_custom_emoji_atlas.h"
 #include "base/battery_saving.h"
 #include "base/event_filter.h"
 #include "base/concurrent_timer.h"
@@ -39,6 +41,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_updates.h"
 #include "calls/calls_instance.h"
 #include "countries/countries_manager.h"
+#include "dialogs/dialogs_main_list.h"
 #include "iv/iv_delegate_impl.h"
 #include "iv/iv_instance.h"
 #include "iv/iv_data.h"
@@ -51,6 +54,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "tray.h"
 #include "core/click_handler_types.h" // ClickHandlerContext.
 #include "core/crash_reports.h"
+#include "core/startup_timeline.h"
 #include "main/main_account.h"
 #include "main/main_domain.h"
 #include "main/main_session.h"
@@ -137,6 +141,8 @@ Application *Application::Instance = nullptr;
 const char kOptionSkipUrlSchemeRegister[] = "skip-url-scheme-register";
 
 struct Application::Private {
+	StartupTimeline startupTimeline;
+	rpl::lifetime firstChatsListLifetime;
 	base::Timer quitTimer;
 	UiIntegration uiIntegration;
 	Settings settings;
@@ -154,6 +160,8 @@ Application::Application()
 , _audio(std::make_unique<Media::Audio::Instance>())
 , _fallbackProductionConfig(
 	std::make_unique<MTP::Config>(MTP::Environment::Production))
+, _decodedImageCache(std::make_unique<Data::DecodedImageCache>())
+, _customEmojiAtlas(std::make_unique<Data::CustomEmojiFrameAtlas>())
 , _downloadManager(std::make_unique<Data::DownloadManager>())
 , _domain(std::make_unique<Main::Domain>(cDataFile()))
 , _exportManager(std::make_unique<Export::Manager>())
@@ -251,14 +259,26 @@ Application::~Application() {
 }
 
 void Application::run() {
+	auto &timeline = _private->startupTimeline;
+
+	// Independent from everything, warm the mime database up
+	// in the background, so it won't be slow later.
+	timeline.async("mime_database", [] {
+		QMimeDatabase().mimeTypeForName(u"text/plain"_q);
+	});
+
 	// Depends on OpenSSL on macOS, so on ThirdParty::start().
 	// Depends on notifications settings.
 	_notifications = std::make_unique<Window::Notifications::System>();
 
+	auto step = timeline.step("local_storage");
 	startLocalStorage();
+	step.finish();
 
+	auto fonts = timeline.step("fonts");
 	style::SetCustomFont(settings().customFontFamily());
 	style::internal::StartFonts();
+	fonts.finish();
 
 	ValidateScale();
 
@@ -282,15 +302,27 @@ void Application::run() {
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
+	auto styles = timeline.step("styles");
 	style::StartManager(cScale());
 	Ui::InitTextOptions();
 	Ui::StartCachedCorners();
+	styles.finish();
+
+	auto emoji = timeline.step("emoji");
 	Ui::Emoji::Init();
 	Ui::PreloadTextSpoilerMask();
+	emoji.finish();
+
+	auto shortcuts = timeline.step("shortcuts");
 	startShortcuts();
+	shortcuts.finish();
+
 	startEmojiImageLoader();
 	startSystemDarkModeViewer();
+
+	auto audio = timeline.step("audio");
 	Media::Player::start(_audio.get());
+	audio.finish();
 
 	if (MediaControlsManager::Supported()) {
 		_mediaControlsManager = std::make_unique<MediaControlsManager>();
@@ -316,15 +348,14 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: starting app..."));
 
-	// Create mime database, so it won't be slow later.
-	QMimeDatabase().mimeTypeForName(u"text/plain"_q);
-
 	// Check now to avoid re-entrance later.
 	[[maybe_unused]] const auto ivSupported = Iv::ShowButton();
 
+	auto window = timeline.step("window");
 	_windows.emplace(nullptr, std::make_unique<Window::Controller>());
 	setLastActiveWindow(_windows.front().second.get());
 	_windowInSettings = _lastActivePrimaryWindow = _lastActiveWindow;
+	window.finish();
 
 	_domain->activeChanges(
 	) | rpl::start_with_next([=](not_null<Main::Account*> account) {
@@ -369,15 +400,27 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: window created..."));
 
+	trackFirstChatsList();
+
+	auto domain = timeline.step("domain");
 	startDomain();
+	domain.finish();
+
 	startTray();
 
+	auto show = timeline.step("first_show");
 	_lastActivePrimaryWindow->firstShow();
 
 	startMediaView();
 
 	DEBUG_LOG(("Application Info: showing."));
 	_lastActivePrimaryWindow->finishFirstShow();
+	show.finish();
+
+	if (passcodeLocked() || !maybePrimarySession()) {
+		// No chats list will be shown until a passcode or a login.
+		finishStartupTimeline("no_chats_list");
+	}
 
 	if (!_lastActivePrimaryWindow->locked() && cStartToSettings()) {
 		_lastActivePrimaryWindow->showSettings();
@@ -411,6 +454,55 @@ void Application::run() {
 	processCreatedWindow(_lastActivePrimaryWindow);
 }
 
+void Application::trackFirstChatsList() {
+	// Time to the first chats list is the main startup metric.
+	_domain->activeSessionValue(
+	) | rpl::map([=](Main::Session *session) {
+		if (!session) {
+			return rpl::never<const char*>() | rpl::type_erased();
+		}
+		const auto owner = &session->data();
+		auto filled = rpl::single<Data::Folder*>(
+			nullptr
+		) | rpl::then(
+			owner->chatsListChanges()
+		) | rpl::filter([=](Data::Folder *folder) {
+			return !folder && !owner->chatsList()->indexed()->empty();
+		}) | rpl::map([] { return "first_chats_list"; });
+		auto loaded = rpl::single<Data::Folder*>(
+			nullptr
+		) | rpl::then(
+			owner->chatsListLoadedEvents()
+		) | rpl::filter([=](Data::Folder *folder) {
+			return !folder
+				&& owner->chatsListLoaded()
+				&& owner->chatsList()->indexed()->empty();
+		}) | rpl::map([] { return "empty_chats_list"; });
+		return rpl::merge(
+			std::move(filled),
+			std::move(loaded)
+		) | rpl::type_erased();
+	}) | rpl::flatten_latest(
+	) | rpl::take(1) | rpl::start_with_next([=](const char *name) {
+		finishStartupTimeline(name);
+	}, _private->firstChatsListLifetime);
+}
+
+void Application::finishStartupTimeline(const char *name) {
+	_private->firstChatsListLifetime.destroy();
+
+	auto &timeline = _private->startupTimeline;
+	timeline.mark(name);
+	LOG(("Startup Info: Finished with %1 in %2 ms."
+		).arg(QString::fromLatin1(name)
+		).arg(timeline.elapsed()));
+	timeline.finish();
+}
+
+StartupTimeline &Application::startupTimeline() const {
+	return _private->startupTimeline;
+}
+
 void Application::autoRegisterUrlScheme() {
 	if (!OptionSkipUrlSchemeRegister.value()) {
 		InvokeQueued(this, [] { RegisterUrlScheme(); });
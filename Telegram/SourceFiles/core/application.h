@@ -91,6 +91,8 @@ class CloudManager;
 namespace Data {
 struct CloudTheme;
 class DownloadManager;
+class DecodedImageCache;
+class CustomEmojiFrameAtlas;
 } // namespace Data
 
 namespace Stickers {
@@ -114,6 +116,7 @@ namespace Core {
 struct LocalUrlHandler;
 class Settings;
 class Tray;
+class StartupTimeline;
 
 enum class LaunchState {
 	Running,
@@ -156,6 +159,13 @@ public:
 	[[nodiscard]] Data::DownloadManager &downloadManager() const {
 		return *_downloadManager;
 	}
+	[[nodiscard]] Data::DecodedImageCache &decodedImageCache() const {
+		return *_decodedImageCache;
+	}
+	[[nodiscard]] Data::CustomEmojiFrameAtlas &customEmojiAtlas() const {
+		return *_customEmojiAtlas;
+	}
+	[[nodiscard]] StartupTimeline &startupTimeline() const;
 	[[nodiscard]] Tray &tray() const {
 		return *_tray;
 	}
@@ -352,6 +362,8 @@ private:
 	friend Application &App();
 
 	void autoRegisterUrlScheme();
+	void trackFirstChatsList();
+	void finishStartupTimeline(const char *name);
 	void clearEmojiSourceImages();
 	[[nodiscard]] auto prepareEmojiSourceImages()
 		-> std::shared_ptr<Ui::Emoji::UniversalImages>;
@@ -418,6 +430,8 @@ private:
 
 	using MediaControlsManager = Media::SystemMediaControlsManager;
 	std::unique_ptr<MediaControlsManager> _mediaControlsManager;
+	const std::unique_ptr<Data::DecodedImageCache> _decodedImageCache;
+	const std::unique_ptr<Data::CustomEmojiFrameAtlas> _customEmojiAtlas;
 	const std::unique_ptr<Data::DownloadManager> _downloadManager;
 	const std::unique_ptr<Main::Domain> _domain;
 	const std::unique_ptr<Export::Manager> _exportManager;
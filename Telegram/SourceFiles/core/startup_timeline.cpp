@@ -0,0 +1,160 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/startup_timeline.h"
+
+#include "logs.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+
+namespace Core {
+
+StartupTimeline::Step::Step(
+	not_null<StartupTimeline*> timeline,
+	const char *name)
+: _timeline(timeline)
+, _name(name)
+, _started(crl::now()) {
+}
+
+StartupTimeline::Step::Step(Step &&other)
+: _timeline(base::take(other._timeline))
+, _name(other._name)
+, _started(other._started) {
+}
+
+StartupTimeline::Step::~Step() {
+	finish();
+}
+
+void StartupTimeline::Step::finish() {
+	if (const auto timeline = base::take(_timeline)) {
+		timeline->add({
+			.name = _name,
+			.start = _started,
+			.duration = crl::now() - _started,
+			.thread = CurrentThread(),
+		});
+	}
+}
+
+StartupTimeline::StartupTimeline() : _started(crl::now()) {
+}
+
+StartupTimeline::~StartupTimeline() = default;
+
+auto StartupTimeline::step(const char *name) -> Step {
+	return Step(this, name);
+}
+
+void StartupTimeline::async(
+		const char *name,
+		FnMut<void()> task,
+		FnMut<void()> done) {
+	const auto weak = base::make_weak(this);
+	crl::async([=, task = std::move(task), done = std::move(done)]() mutable {
+		const auto start = crl::now();
+		task();
+		const auto event = Event{
+			.name = name,
+			.start = start,
+			.duration = crl::now() - start,
+			.thread = CurrentThread(),
+		};
+		crl::on_main(weak, [=, done = std::move(done)]() mutable {
+			add(event);
+			if (done) {
+				done();
+			}
+		});
+	});
+}
+
+void StartupTimeline::mark(const char *name) {
+	add({
+		.name = name,
+		.start = crl::now(),
+		.thread = CurrentThread(),
+	});
+}
+
+crl::time StartupTimeline::elapsed() const {
+	return crl::now() - _started;
+}
+
+void StartupTimeline::add(Event event) {
+	QMutexLocker lock(&_mutex);
+	if (!_finished) {
+		_events.push_back(event);
+	}
+}
+
+void StartupTimeline::finish() {
+	auto events = std::vector<Event>();
+	{
+		QMutexLocker lock(&_mutex);
+		if (_finished) {
+			return;
+		}
+		_finished = true;
+		events = base::take(_events);
+	}
+	auto summary = QStringList();
+	for (const auto &event : events) {
+		const auto name = QString::fromLatin1(event.name);
+		summary.push_back((event.duration >= 0)
+			? u"%1 %2 ms"_q.arg(name).arg(event.duration)
+			: u"%1 at %2 ms"_q.arg(name).arg(event.start - _started));
+	}
+	LOG(("Startup Info: %1.").arg(summary.join(u", "_q)));
+
+	if (Logs::DebugEnabled()) {
+		write(events);
+	}
+}
+
+void StartupTimeline::write(const std::vector<Event> &events) const {
+	auto entries = QStringList();
+	for (const auto &event : events) {
+		const auto name = QString::fromLatin1(event.name);
+		const auto start = (event.start - _started) * 1000;
+		entries.push_back((event.duration >= 0)
+			? (u"{\"name\":\"%1\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,"
+				"\"pid\":1,\"tid\":%4}"_q
+				).arg(name
+				).arg(start
+				).arg(event.duration * 1000
+				).arg(event.thread)
+			: (u"{\"name\":\"%1\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%2,"
+				"\"pid\":1,\"tid\":%3}"_q
+				).arg(name
+				).arg(start
+				).arg(event.thread));
+	}
+	const auto path = cWorkingDir() + u"DebugLogs/startup.json"_q;
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Error: Could not write '%1'.").arg(path));
+		return;
+	}
+	f.write("{\"traceEvents\":[\n");
+	f.write(entries.join(u",\n"_q).toUtf8());
+	f.write("\n]}\n");
+}
+
+int StartupTimeline::CurrentThread() {
+	const auto current = QThread::currentThread();
+	const auto main = QCoreApplication::instance()
+		? QCoreApplication::instance()->thread()
+		: nullptr;
+	return (current == main)
+		? 0
+		: int(quintptr(QThread::currentThreadId()) & 0x7FFFFFFF);
+}
+
+} // namespace Core
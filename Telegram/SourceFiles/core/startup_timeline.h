@@ -0,0 +1,78 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+#include <QtCore/QMutex>
+
+namespace Core {
+
+// Timeline of the application startup steps.
+//
+// Steps may be recorded from any thread. When debug logs are enabled
+// the timeline is written in the Chrome trace event format to
+// DebugLogs/startup.json, the summary always goes to the main log.
+class StartupTimeline final : public base::has_weak_ptr {
+public:
+	class Step final {
+	public:
+		Step(Step &&other);
+		Step &operator=(Step &&other) = delete;
+		~Step();
+
+		void finish();
+
+	private:
+		friend class StartupTimeline;
+
+		Step(not_null<StartupTimeline*> timeline, const char *name);
+
+		StartupTimeline *_timeline = nullptr;
+		const char *_name = nullptr;
+		crl::time _started = 0;
+
+	};
+
+	StartupTimeline();
+	~StartupTimeline();
+
+	[[nodiscard]] Step step(const char *name);
+
+	// Runs the step in a background thread, then records it and calls
+	// done() on main, unless the timeline was destroyed by that time.
+	void async(
+		const char *name,
+		FnMut<void()> task,
+		FnMut<void()> done = nullptr);
+
+	void mark(const char *name);
+	void finish();
+
+	[[nodiscard]] crl::time elapsed() const;
+
+private:
+	struct Event {
+		const char *name = nullptr;
+		crl::time start = 0;
+		crl::time duration = -1; // Instant event.
+		int thread = 0;
+	};
+
+	void add(Event event);
+	void write(const std::vector<Event> &events) const;
+	[[nodiscard]] static int CurrentThread();
+
+	const crl::time _started = 0;
+	mutable QMutex _mutex;
+	std::vector<Event> _events;
+	bool _finished = false;
+
+};
+
+} // namespace Core
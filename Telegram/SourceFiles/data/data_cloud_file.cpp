@@ -241,7 +241,8 @@ void LoadCloudFile(
 		Fn<void(CloudFile&)> done,
 		Fn<void(bool)> fail,
 		Fn<void()> progress,
-		int downloadFrontPartSize = 0) {
+		int downloadFrontPartSize = 0,
+		QSize decodeBox = QSize()) {
 	const auto loadSize = downloadFrontPartSize
 		? std::min(downloadFrontPartSize, file.byteSize)
 		: file.byteSize;
@@ -251,6 +252,16 @@ void LoadCloudFile(
 		}
 		if (file.loader->loadSize() < loadSize) {
 			file.loader->increaseLoadSize(loadSize, autoLoading);
+			file.loader->setImageDecodeBox(decodeBox);
+		} else if (const auto box = file.loader->imageDecodeBox()
+			; !box.isEmpty()
+			&& (decodeBox.isEmpty()
+				|| box.width() < decodeBox.width()
+				|| box.height() < decodeBox.height())) {
+			// Someone wants the same bytes decoded in a larger size.
+			file.loader->setImageDecodeBox(decodeBox.isEmpty()
+				? QSize()
+				: box.expandedTo(decodeBox));
 		}
 		return;
 	} else if ((file.flags & CloudFile::Flag::Failed)
@@ -271,6 +282,7 @@ void LoadCloudFile(
 		fromCloud,
 		autoLoading,
 		cacheTag);
+	file.loader->setImageDecodeBox(decodeBox);
 
 	const auto finish = [done](CloudFile &file) {
 		if (!file.loader || file.loader->cancelled()) {
@@ -317,7 +329,8 @@ void LoadCloudFile(
 		Fn<void(QImage, QByteArray)> done,
 		Fn<void(bool)> fail,
 		Fn<void()> progress,
-		int downloadFrontPartSize) {
+		int downloadFrontPartSize,
+		QSize decodeBox) {
 	const auto callback = [=](CloudFile &file) {
 		if (auto read = file.loader->imageData(); read.isNull()) {
 			file.flags |= CloudFile::Flag::Failed;
@@ -339,7 +352,8 @@ void LoadCloudFile(
 		callback,
 		std::move(fail),
 		std::move(progress),
-		downloadFrontPartSize);
+		downloadFrontPartSize,
+		decodeBox);
 }
 
 void LoadCloudFile(
@@ -102,7 +102,8 @@ void LoadCloudFile(
 	Fn<void(QImage, QByteArray)> done,
 	Fn<void(bool)> fail = nullptr,
 	Fn<void()> progress = nullptr,
-	int downloadFrontPartSize = 0);
+	int downloadFrontPartSize = 0,
+	QSize decodeBox = QSize());
 
 void LoadCloudFile(
 	not_null<Main::Session*> session,
@@ -0,0 +1,199 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_decoded_image_cache.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kDefaultLimit = int64(256 * 1024 * 1024);
+
+// Evict a bit more than required, so that we don't evict on each image.
+constexpr auto kEvictTillPercent = 90;
+
+} // namespace
+
+DecodedImageCache::Entry::Entry(
+	not_null<DecodedImageCache*> owner,
+	int index,
+	uint32 generation)
+: _owner(owner.get())
+, _index(index)
+, _generation(generation) {
+}
+
+DecodedImageCache::Entry::Entry(Entry &&other)
+: _owner(base::take(other._owner))
+, _index(std::exchange(other._index, -1))
+, _generation(base::take(other._generation)) {
+}
+
+auto DecodedImageCache::Entry::operator=(Entry &&other) -> Entry & {
+	if (this != &other) {
+		release();
+		_owner = base::take(other._owner);
+		_index = std::exchange(other._index, -1);
+		_generation = base::take(other._generation);
+	}
+	return *this;
+}
+
+DecodedImageCache::Entry::~Entry() {
+	release();
+}
+
+DecodedImageCache::Entry::operator bool() const {
+	return (_index >= 0);
+}
+
+void DecodedImageCache::Entry::touch() const {
+	if (const auto owner = _owner.get()) {
+		owner->touch(_index, _generation);
+	}
+}
+
+void DecodedImageCache::Entry::release() {
+	if (const auto owner = _owner.get()) {
+		owner->forget(_index, _generation);
+	}
+	_owner = base::weak_ptr<DecodedImageCache>();
+	_index = -1;
+}
+
+DecodedImageCache::DecodedImageCache()
+: _limit(kDefaultLimit) {
+}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+int64 DecodedImageCache::DefaultLimit() {
+	return kDefaultLimit;
+}
+
+void DecodedImageCache::setLimit(int64 bytes) {
+	_limit = std::max(bytes, int64(0));
+	checkLimit();
+}
+
+auto DecodedImageCache::track(const QImage &image, Fn<void()> evict)
+-> Entry {
+	Expects(evict != nullptr);
+
+	if (image.isNull()) {
+		return Entry();
+	}
+	auto index = 0;
+	if (!_freeSlots.empty()) {
+		index = _freeSlots.back();
+		_freeSlots.pop_back();
+	} else {
+		index = int(_slots.size());
+		_slots.emplace_back();
+	}
+	auto &slot = _slots[index];
+	slot.evict = std::move(evict);
+	slot.bytes = image.sizeInBytes();
+	slot.referenced = true;
+	_bytes += slot.bytes;
+	++_entries;
+	checkLimit();
+	return Entry(this, index, slot.generation);
+}
+
+void DecodedImageCache::countMiss() {
+	++_misses;
+}
+
+auto DecodedImageCache::stats() const -> Stats {
+	return {
+		.hits = _hits,
+		.misses = _misses,
+		.evictions = _evictions,
+		.bytes = _bytes,
+		.limit = _limit,
+		.entries = _entries,
+	};
+}
+
+void DecodedImageCache::touch(int index, uint32 generation) {
+	Expects(index >= 0 && index < int(_slots.size()));
+
+	auto &slot = _slots[index];
+	if (slot.generation == generation && slot.evict) {
+		slot.referenced = true;
+		++_hits;
+	}
+}
+
+void DecodedImageCache::forget(int index, uint32 generation) {
+	Expects(index >= 0 && index < int(_slots.size()));
+
+	const auto &slot = _slots[index];
+	if (slot.generation == generation && slot.evict) {
+		releaseSlot(index);
+	}
+}
+
+Fn<void()> DecodedImageCache::releaseSlot(int index) {
+	auto &slot = _slots[index];
+	auto result = base::take(slot.evict);
+	_bytes -= slot.bytes;
+	--_entries;
+	slot = Slot{ .generation = slot.generation + 1 };
+	_freeSlots.push_back(index);
+	return result;
+}
+
+void DecodedImageCache::checkLimit() {
+	if (_bytes <= _limit || _evictScheduled) {
+		return;
+	}
+	_evictScheduled = true;
+
+	// Evict later, so that no Image pointer obtained by a caller
+	// in the current event loop iteration becomes dangling.
+	crl::on_main(this, [=] {
+		_evictScheduled = false;
+		evict();
+	});
+}
+
+void DecodedImageCache::evict() {
+	const auto till = _limit * kEvictTillPercent / 100;
+	const auto count = int(_slots.size());
+	auto evicted = 0;
+	for (auto checked = 0
+		; (_bytes > till) && (checked != 2 * count)
+		; ++checked) {
+		if (_hand >= count) {
+			_hand = 0;
+		}
+		auto &slot = _slots[_hand];
+		const auto index = _hand++;
+		if (!slot.evict) {
+			continue;
+		} else if (slot.referenced) {
+			slot.referenced = false;
+			continue;
+		}
+		const auto callback = releaseSlot(index);
+		++_evictions;
+		++evicted;
+		callback();
+	}
+	if (evicted) {
+		DEBUG_LOG(("Images Cache: Evicted %1, now %2 bytes in %3 images, "
+			"hits %4, misses %5."
+			).arg(evicted
+			).arg(_bytes
+			).arg(_entries
+			).arg(_hits
+			).arg(_misses));
+	}
+}
+
+} // namespace Data
@@ -0,0 +1,95 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+namespace Data {
+
+// Global budget for decoded media images (PhotoMedia, DocumentMedia).
+//
+// Owners register each decoded image together with a callback that drops
+// it, the cache evicts least recently used images (CLOCK approximation)
+// when the summary size goes over the limit. Owners re-decode evicted
+// images on demand from the encoded bytes or the local cache database.
+class DecodedImageCache final : public base::has_weak_ptr {
+public:
+	struct Stats {
+		int64 hits = 0;
+		int64 misses = 0;
+		int64 evictions = 0;
+		int64 bytes = 0;
+		int64 limit = 0;
+		int entries = 0;
+	};
+
+	class Entry final {
+	public:
+		Entry() = default;
+		Entry(Entry &&other);
+		Entry &operator=(Entry &&other);
+		~Entry();
+
+		explicit operator bool() const;
+		void touch() const;
+
+	private:
+		friend class DecodedImageCache;
+
+		Entry(
+			not_null<DecodedImageCache*> owner,
+			int index,
+			uint32 generation);
+
+		void release();
+
+		base::weak_ptr<DecodedImageCache> _owner;
+		int _index = -1;
+		uint32 _generation = 0;
+
+	};
+
+	DecodedImageCache();
+	~DecodedImageCache();
+
+	[[nodiscard]] static int64 DefaultLimit();
+	void setLimit(int64 bytes);
+
+	[[nodiscard]] Entry track(const QImage &image, Fn<void()> evict);
+	void countMiss();
+
+	[[nodiscard]] Stats stats() const;
+
+private:
+	struct Slot {
+		Fn<void()> evict;
+		int64 bytes = 0;
+		uint32 generation = 0;
+		bool referenced = false;
+	};
+
+	void touch(int index, uint32 generation);
+	void forget(int index, uint32 generation);
+	Fn<void()> releaseSlot(int index);
+	void checkLimit();
+	void evict();
+
+	std::vector<Slot> _slots;
+	std::vector<int> _freeSlots;
+	int _hand = 0;
+	int _entries = 0;
+	int64 _bytes = 0;
+	int64 _limit = 0;
+	int64 _hits = 0;
+	int64 _misses = 0;
+	int64 _evictions = 0;
+	bool _evictScheduled = false;
+
+};
+
+} // namespace Data
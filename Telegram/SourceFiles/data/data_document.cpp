@@ -291,16 +291,6 @@ bool StickerData::isWebm() const {
 	return (type == StickerType::Webm);
 }
 
-VoiceData::~VoiceData() {
-	if (!waveform.isEmpty()
-		&& waveform[0] == -1
-		&& waveform.size() > int32(sizeof(TaskId))) {
-		auto taskId = TaskId();
-		memcpy(&taskId, waveform.constData() + 1, sizeof(taskId));
-		Local::cancelTask(taskId);
-	}
-}
-
 DocumentData::DocumentData(not_null<Data::Session*> owner, DocumentId id)
 : id(id)
 , _owner(owner) {
@@ -1671,6 +1661,10 @@ Storage::Cache::Key DocumentData::cacheKey() const {
 	}
 }
 
+Storage::Cache::Key DocumentData::waveformCacheKey() const {
+	return Data::DocumentWaveformCacheKey(_dc, id);
+}
+
 uint8 DocumentData::cacheTag() const {
 	if (type == StickerDocument) {
 		return Data::kStickerCacheTag;
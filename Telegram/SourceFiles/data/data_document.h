@@ -88,8 +88,6 @@ struct SongData : public DocumentAdditionalData {
 };
 
 struct VoiceData : public DocumentAdditionalData {
-	~VoiceData();
-
 	VoiceWaveform waveform;
 	char wavemax = 0;
 };
@@ -286,6 +284,7 @@ public:
 
 	[[nodiscard]] MediaKey mediaKey() const;
 	[[nodiscard]] Storage::Cache::Key cacheKey() const;
+	[[nodiscard]] Storage::Cache::Key waveformCacheKey() const;
 	[[nodiscard]] uint8 cacheTag() const;
 
 	[[nodiscard]] bool canBeStreamed(HistoryItem *item) const;
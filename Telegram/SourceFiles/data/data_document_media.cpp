@@ -88,6 +88,14 @@ enum class FileType {
 		|| (size.width() * size.height() > kReadAreaLimit)) {
 		return QImage();
 	}
+	const auto limit = QSize(
+		kWallPaperThumbnailLimit,
+		kWallPaperThumbnailLimit);
+	if ((size.width() > limit.width() || size.height() > limit.height())
+		&& reader.supportsOption(QImageIOHandler::ScaledSize)) {
+		// Let the decoder skip the full resolution (scaled IDCT for JPEG).
+		reader.setScaledSize(size.scaled(limit, Qt::KeepAspectRatio));
+	}
 	auto result = reader.read();
 	if (!result.width() || !result.height()) {
 		return QImage();
@@ -176,6 +184,8 @@ Image *DocumentMedia::goodThumbnail() const {
 
 	if (!_goodThumbnail) {
 		ReadOrGenerateThumbnail(_owner);
+	} else {
+		_goodThumbnailCached.touch();
 	}
 	return _goodThumbnail.get();
 }
@@ -185,6 +195,10 @@ void DocumentMedia::setGoodThumbnail(QImage thumbnail) {
 		return;
 	}
 	_goodThumbnail = std::make_unique<Image>(std::move(thumbnail));
+	trackDecoded(
+		_goodThumbnail,
+		_goodThumbnailCached,
+		Flag::GoodThumbnailEvicted);
 	_owner->session().notifyDownloaderTaskFinished();
 }
 
@@ -217,6 +231,9 @@ const QPainterPath &DocumentMedia::thumbnailPath() const {
 }
 
 Image *DocumentMedia::thumbnail() const {
+	if (_thumbnail) {
+		_thumbnailCached.touch();
+	}
 	return _thumbnail.get();
 }
 
@@ -236,6 +253,7 @@ QSize DocumentMedia::thumbnailSize() const {
 
 void DocumentMedia::setThumbnail(QImage thumbnail) {
 	_thumbnail = std::make_unique<Image>(std::move(thumbnail));
+	trackDecoded(_thumbnail, _thumbnailCached, Flag::ThumbnailEvicted);
 	_owner->session().notifyDownloaderTaskFinished();
 }
 
@@ -261,6 +279,7 @@ void DocumentMedia::setVideoThumbnail(QByteArray content) {
 
 void DocumentMedia::checkStickerLarge() {
 	if (_sticker) {
+		_stickerCached.touch();
 		return;
 	}
 	const auto data = _owner->sticker();
@@ -280,6 +299,27 @@ void DocumentMedia::checkStickerLarge() {
 	} else {
 		_sticker = std::make_unique<Image>(_bytes);
 	}
+	if (_sticker) {
+		trackDecoded(_sticker, _stickerCached, Flag::StickerEvicted);
+	}
+}
+
+void DocumentMedia::trackDecoded(
+		std::unique_ptr<Image> &image,
+		DecodedImageCache::Entry &entry,
+		Flag evicted) {
+	auto &cache = Core::App().decodedImageCache();
+	if (_flags & evicted) {
+		_flags &= ~evicted;
+		cache.countMiss();
+	}
+	const auto raw = &image;
+	const auto rawEntry = &entry;
+	entry = cache.track(image->original(), [=] {
+		*raw = nullptr;
+		*rawEntry = DecodedImageCache::Entry();
+		_flags |= evicted;
+	});
 }
 
 void DocumentMedia::automaticLoad(
@@ -321,21 +361,27 @@ void DocumentMedia::automaticLoad(
 }
 
 void DocumentMedia::collectLocalData(not_null<DocumentMedia*> local) {
+	_flags = local->_flags;
 	if (const auto image = local->_goodThumbnail.get()) {
 		_goodThumbnail = std::make_unique<Image>(image->original());
+		trackDecoded(
+			_goodThumbnail,
+			_goodThumbnailCached,
+			Flag::GoodThumbnailEvicted);
 	}
 	if (const auto image = local->_inlineThumbnail.get()) {
 		_inlineThumbnail = std::make_unique<Image>(image->original());
 	}
 	if (const auto image = local->_thumbnail.get()) {
 		_thumbnail = std::make_unique<Image>(image->original());
+		trackDecoded(_thumbnail, _thumbnailCached, Flag::ThumbnailEvicted);
 	}
 	if (const auto image = local->_sticker.get()) {
 		_sticker = std::make_unique<Image>(image->original());
+		trackDecoded(_sticker, _stickerCached, Flag::StickerEvicted);
 	}
 	_bytes = local->_bytes;
 	_videoThumbnailBytes = local->_videoThumbnailBytes;
-	_flags = local->_flags;
 }
 
 void DocumentMedia::setBytes(const QByteArray &bytes) {
@@ -405,6 +451,7 @@ void DocumentMedia::checkStickerLarge(not_null<FileLoader*> loader) {
 	}
 	if (auto image = loader->imageData(); !image.isNull()) {
 		_sticker = std::make_unique<Image>(std::move(image));
+		trackDecoded(_sticker, _stickerCached, Flag::StickerEvicted);
 	}
 }
 
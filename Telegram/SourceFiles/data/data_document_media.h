@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "base/flags.h"
+#include "data/data_decoded_image_cache.h"
 
 class Image;
 class FileLoader;
@@ -90,6 +91,9 @@ public:
 private:
 	enum class Flag : uchar {
 		GoodThumbnailWanted = 0x01,
+		GoodThumbnailEvicted = 0x02,
+		ThumbnailEvicted = 0x04,
+		StickerEvicted = 0x08,
 	};
 	inline constexpr bool is_flag_type(Flag) { return true; };
 	using Flags = base::flags<Flag>;
@@ -101,6 +105,11 @@ private:
 
 	[[nodiscard]] bool thumbnailEnoughForSticker() const;
 
+	void trackDecoded(
+		std::unique_ptr<Image> &image,
+		DecodedImageCache::Entry &entry,
+		Flag evicted);
+
 	// NB! Right now DocumentMedia can outlive Main::Session!
 	// In DocumentData::collectLocalData a shared_ptr is sent on_main.
 	// In case this is a problem the ~Gif code should be rewritten.
@@ -110,6 +119,9 @@ private:
 	mutable QPainterPath _pathThumbnail;
 	std::unique_ptr<Image> _thumbnail;
 	std::unique_ptr<Image> _sticker;
+	DecodedImageCache::Entry _goodThumbnailCached;
+	DecodedImageCache::Entry _thumbnailCached;
+	DecodedImageCache::Entry _stickerCached;
 	QByteArray _bytes;
 	QByteArray _videoThumbnailBytes;
 	Flags _flags;
@@ -319,7 +319,8 @@ void PhotoData::load(
 		PhotoSize size,
 		Data::FileOrigin origin,
 		LoadFromCloudSetting fromCloud,
-		bool autoLoading) {
+		bool autoLoading,
+		QSize decodeBox) {
 	const auto valid = validSizeIndex(size);
 	const auto existing = existingSizeIndex(size);
 
@@ -348,11 +349,15 @@ void PhotoData::load(
 			}
 		}
 		if (const auto active = activeMediaView()) {
+			const auto box = _images[valid].loader->imageDecodeBox();
+			const auto limited = (box.width() < SideLimit())
+				|| (box.height() < SideLimit());
 			active->set(
 				validSize,
 				goodFor,
 				ValidatePhotoImage(std::move(result), _images[valid]),
-				std::move(bytes));
+				std::move(bytes),
+				limited ? box : QSize());
 		}
 		if (validSize == PhotoSize::Large && goodFor == validSize) {
 			_owner->photoLoadDone(this);
@@ -368,6 +373,19 @@ void PhotoData::load(
 			_owner->photoLoadProgress(this);
 		}
 	};
+	// A progressive front part is good only for the smaller size,
+	// so there is no need to decode it in the full resolution.
+	// Chat bubbles pass the box they display the photo in, everything
+	// else (media viewer, saving) gets the photo side limit.
+	const auto &partial = _images[existing].location;
+	const auto limit = QSize(SideLimit(), SideLimit());
+	const auto box = (existing != valid
+		&& partial.width() > 0
+		&& partial.height() > 0)
+		? QSize(partial.width(), partial.height())
+		: decodeBox.isEmpty()
+		? limit
+		: decodeBox.boundedTo(limit);
 	Data::LoadCloudFile(
 		&session(),
 		_images[valid],
@@ -379,7 +397,8 @@ void PhotoData::load(
 		done,
 		fail,
 		progress,
-		_images[existing].progressivePartSize);
+		_images[existing].progressivePartSize,
+		box);
 
 	if (size == PhotoSize::Large) {
 		_owner->notifyPhotoLayoutChanged(this);
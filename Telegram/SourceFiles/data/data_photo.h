@@ -131,7 +131,8 @@ public:
 		Data::PhotoSize size,
 		Data::FileOrigin origin,
 		LoadFromCloudSetting fromCloud = LoadFromCloudOrLocal,
-		bool autoLoading = false);
+		bool autoLoading = false,
+		QSize decodeBox = QSize());
 	[[nodiscard]] const ImageLocation &location(Data::PhotoSize size) const;
 	[[nodiscard]] std::optional<QSize> size(Data::PhotoSize size) const;
 	[[nodiscard]] int imageByteSize(Data::PhotoSize size) const;
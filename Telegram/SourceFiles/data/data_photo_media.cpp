@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "data/data_file_origin.h"
 #include "data/data_session.h"
+#include "core/application.h"
 #include "history/history.h"
 #include "history/history_item.h"
 #include "main/main_session.h"
@@ -56,40 +57,149 @@ Image *PhotoMedia::image(PhotoSize size) const {
 }
 
 QByteArray PhotoMedia::imageBytes(PhotoSize size) const {
-	if (const auto resolved = resolveLoadedImage(size)) {
+	if (const auto resolved = resolveLoadedImage(size, false)) {
 		return resolved->bytes;
 	}
 	return QByteArray();
 }
 
-auto PhotoMedia::resolveLoadedImage(PhotoSize size) const
+auto PhotoMedia::resolveLoadedImage(
+	PhotoSize size,
+	bool needDecoded) const
 -> const PhotoImage * {
-	const auto &original = _images[PhotoSizeIndex(size)];
-	if (const auto image = original.data.get()) {
-		if (original.goodFor >= size) {
-			return &original;
-		}
+	const auto good = [&](int index) {
+		const auto &entry = _images[index];
+		return entry.exists()
+			&& (entry.goodFor >= size)
+			&& (!needDecoded || decoded(index));
+	};
+	const auto index = PhotoSizeIndex(size);
+	if (good(index)) {
+		return &_images[index];
 	}
-	const auto &valid = _images[_owner->validSizeIndex(size)];
-	if (const auto image = valid.data.get()) {
-		if (valid.goodFor >= size) {
-			return &valid;
-		}
+	const auto validIndex = _owner->validSizeIndex(size);
+	if (good(validIndex)) {
+		return &_images[validIndex];
 	}
 	return nullptr;
 }
 
-void PhotoMedia::wanted(PhotoSize size, Data::FileOrigin origin) {
+Image *PhotoMedia::decoded(int index) const {
+	auto &entry = _images[index];
+	if (const auto image = entry.data.get()) {
+		entry.cached.touch();
+		return image;
+	} else if (!entry.bytes.isEmpty()) {
+		// Evicted from the decoded images cache, we still have the bytes.
+		// Callers fall back to smaller sizes until it is decoded again.
+		decodeAsync(index, entry.decodeBox);
+	}
+	return nullptr;
+}
+
+void PhotoMedia::decodeAsync(int index, QSize box) const {
+	auto &entry = _images[index];
+	if (entry.decoding) {
+		return;
+	} else if (!entry.data) {
+		Core::App().decodedImageCache().countMiss();
+	}
+	entry.decoding = true;
+	const auto bytes = entry.bytes;
+	const auto limit = PhotoData::SideLimit();
+	const auto read = box.isEmpty() ? QSize(limit, limit) : box;
+	const auto weak = base::make_weak(this);
+	crl::async([=] {
+		auto image = Images::ReadDownscaled(bytes, read);
+		if (image.width() > limit || image.height() > limit) {
+			image = image.scaled(
+				limit,
+				limit,
+				Qt::KeepAspectRatio,
+				Qt::SmoothTransformation);
+		}
+		crl::on_main(weak, [=, image = std::move(image)]() mutable {
+			auto &entry = _images[index];
+			if (!entry.decoding
+				|| entry.bytes.constData() != bytes.constData()) {
+				return;
+			}
+			entry.decoding = false;
+			if (image.isNull()) {
+				if (!entry.data) {
+					entry = PhotoImage();
+				}
+				return;
+			}
+			const auto size = image.size();
+			entry.data = std::make_unique<Image>(std::move(image));
+			entry.size = size;
+			entry.decodeBox = (size.width() < box.width()
+				&& size.height() < box.height())
+				? QSize()
+				: box;
+			trackDecoded(index);
+			_owner->session().notifyDownloaderTaskFinished();
+		});
+	});
+}
+
+void PhotoMedia::trackDecoded(int index) const {
+	auto &entry = _images[index];
+	if (entry.bytes.isEmpty()) {
+		// We won't be able to decode it again, keep it while we live.
+		return;
+	}
+	entry.cached = Core::App().decodedImageCache().track(
+		entry.data->original(),
+		[=] {
+			auto &entry = _images[index];
+			entry.data = nullptr;
+			entry.cached = DecodedImageCache::Entry();
+		});
+}
+
+bool PhotoMedia::imageDownscaled(PhotoSize size) const {
+	if (const auto resolved = resolveLoadedImage(size, false)) {
+		return !resolved->decodeBox.isEmpty() && !resolved->bytes.isEmpty();
+	}
+	return false;
+}
+
+void PhotoMedia::wanted(
+		PhotoSize size,
+		Data::FileOrigin origin,
+		QSize decodeBox) {
 	const auto index = _owner->validSizeIndex(size);
-	if (!_images[index].data || _images[index].goodFor < size) {
-		_owner->load(size, origin);
+	if (!_images[index].exists() || _images[index].goodFor < size) {
+		_owner->load(size, origin, LoadFromCloudOrLocal, false, decodeBox);
+	} else {
+		decodeLarger(index, decodeBox);
+	}
+}
+
+void PhotoMedia::decodeLarger(int index, QSize box) {
+	const auto &entry = _images[index];
+	const auto &was = entry.decodeBox;
+	if (was.isEmpty() || entry.bytes.isEmpty()) {
+		// Decoded in the full resolution or can't be decoded again.
+		return;
+	} else if (!box.isEmpty()
+		&& was.width() >= box.width()
+		&& was.height() >= box.height()) {
+		return;
 	}
+	// The bytes were decoded for a chat bubble, now a larger size is
+	// wanted (media viewer or a wider bubble). Keep showing the smaller
+	// one until the larger one is ready.
+	decodeAsync(index, box.isEmpty() ? QSize() : was.expandedTo(box));
 }
 
 QSize PhotoMedia::size(PhotoSize size) const {
 	const auto index = PhotoSizeIndex(size);
-	if (const auto image = _images[index].data.get()) {
-		return image->size();
+	const auto &entry = _images[index];
+	if (entry.exists() && entry.goodFor >= size) {
+		return entry.size;
 	}
 	const auto &location = _owner->location(size);
 	return { location.width(), location.height() };
@@ -99,7 +209,8 @@ void PhotoMedia::set(
 		PhotoSize size,
 		PhotoSize goodFor,
 		QImage image,
-		QByteArray bytes) {
+		QByteArray bytes,
+		QSize decodeBox) {
 	const auto index = PhotoSizeIndex(size);
 	const auto limit = PhotoData::SideLimit();
 	if (image.width() > limit || image.height() > limit) {
@@ -109,11 +220,20 @@ void PhotoMedia::set(
 			Qt::KeepAspectRatio,
 			Qt::SmoothTransformation);
 	}
+	const auto imageSize = image.size();
+	if (imageSize.width() < decodeBox.width()
+		&& imageSize.height() < decodeBox.height()) {
+		// The box was larger than the image, it is decoded fully.
+		decodeBox = QSize();
+	}
 	_images[index] = PhotoImage{
 		.data = std::make_unique<Image>(std::move(image)),
 		.bytes = std::move(bytes),
+		.size = imageSize,
+		.decodeBox = decodeBox,
 		.goodFor = goodFor,
 	};
+	trackDecoded(index);
 	_owner->session().notifyDownloaderTaskFinished();
 }
 
@@ -140,7 +260,7 @@ void PhotoMedia::setVideo(PhotoSize size, QByteArray content) {
 
 bool PhotoMedia::loaded() const {
 	const auto index = PhotoSizeIndex(PhotoSize::Large);
-	return (_images[index].data != nullptr)
+	return _images[index].exists()
 		&& (_images[index].goodFor >= PhotoSize::Large);
 }
 
@@ -164,16 +284,21 @@ bool PhotoMedia::autoLoadThumbnailAllowed(not_null<PeerData*> peer) const {
 
 void PhotoMedia::automaticLoad(
 		FileOrigin origin,
-		const HistoryItem *item) {
+		const HistoryItem *item,
+		QSize decodeBox) {
 	if (item) {
-		automaticLoad(origin, item->history()->peer);
+		automaticLoad(origin, item->history()->peer, decodeBox);
 	}
 }
 
 void PhotoMedia::automaticLoad(
 		FileOrigin origin,
-		not_null<PeerData*> peer) {
-	if (loaded() || _owner->cancelled()) {
+		not_null<PeerData*> peer,
+		QSize decodeBox) {
+	if (loaded()) {
+		decodeLarger(PhotoSizeIndex(PhotoSize::Large), decodeBox);
+		return;
+	} else if (_owner->cancelled()) {
 		return;
 	}
 	const auto loadFromCloud = Data::AutoDownload::Should(
@@ -191,10 +316,23 @@ void PhotoMedia::collectLocalData(not_null<PhotoMedia*> local) {
 		_inlineThumbnail = std::make_unique<Image>(image->original());
 	}
 	for (auto i = 0; i != kPhotoSizeCount; ++i) {
-		if (const auto image = local->_images[i].data.get()) {
+		const auto &from = local->_images[i];
+		if (const auto image = from.data.get()) {
 			_images[i] = PhotoImage{
 				.data = std::make_unique<Image>(image->original()),
-				.goodFor = local->_images[i].goodFor
+				.bytes = from.bytes,
+				.size = from.size,
+				.decodeBox = from.decodeBox,
+				.goodFor = from.goodFor
+			};
+			trackDecoded(i);
+		} else if (!from.bytes.isEmpty()) {
+			// Evicted in the local media, decode it again on demand.
+			_images[i] = PhotoImage{
+				.bytes = from.bytes,
+				.size = from.size,
+				.decodeBox = from.decodeBox,
+				.goodFor = from.goodFor
 			};
 		}
 	}
@@ -210,9 +348,8 @@ bool PhotoMedia::saveToFile(const QString &path) {
 		QFile f(path);
 		return f.open(QIODevice::WriteOnly)
 			&& (f.write(photo) == photo.size());
-	} else if (const auto fallback = image(large)->original()
-		; !fallback.isNull()) {
-		return fallback.save(path, "JPG");
+	} else if (const auto fallback = image(large)) {
+		return fallback->original().save(path, "JPG");
 	}
 	return false;
 }
@@ -222,7 +359,10 @@ bool PhotoMedia::setToClipboard() {
 	if (const auto video = videoContent(large); !video.isEmpty()) {
 		return false;
 	}
-	auto fallback = image(large)->original();
+	const auto decoded = image(large);
+	auto fallback = decoded
+		? decoded->original()
+		: Images::ReadDownscaled(imageBytes(large), size(large));
 	if (fallback.isNull()) {
 		return false;
 	}
@@ -8,12 +8,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "data/data_photo.h"
+#include "data/data_decoded_image_cache.h"
+#include "base/weak_ptr.h"
 
 class FileLoader;
 
 namespace Data {
 
-class PhotoMedia final {
+class PhotoMedia final : public base::has_weak_ptr {
 public:
 	explicit PhotoMedia(not_null<PhotoData*> owner);
 	~PhotoMedia();
@@ -25,12 +27,20 @@ public:
 	[[nodiscard]] Image *image(PhotoSize size) const;
 	[[nodiscard]] QByteArray imageBytes(PhotoSize size) const;
 	[[nodiscard]] QSize size(PhotoSize size) const;
-	void wanted(PhotoSize size, Data::FileOrigin origin);
+
+	// Decoded only for a chat bubble, wanted() decodes it fully.
+	[[nodiscard]] bool imageDownscaled(PhotoSize size) const;
+	// Empty decodeBox asks for the full resolution (up to the side limit).
+	void wanted(
+		PhotoSize size,
+		Data::FileOrigin origin,
+		QSize decodeBox = QSize());
 	void set(
 		PhotoSize size,
 		PhotoSize goodFor,
 		QImage image,
-		QByteArray bytes);
+		QByteArray bytes,
+		QSize decodeBox = QSize());
 
 	[[nodiscard]] QByteArray videoContent(PhotoSize size) const;
 	[[nodiscard]] QSize videoSize(PhotoSize size) const;
@@ -42,8 +52,14 @@ public:
 
 	[[nodiscard]] bool autoLoadThumbnailAllowed(
 		not_null<PeerData*> peer) const;
-	void automaticLoad(FileOrigin origin, const HistoryItem *item);
-	void automaticLoad(FileOrigin origin, not_null<PeerData*> peer);
+	void automaticLoad(
+		FileOrigin origin,
+		const HistoryItem *item,
+		QSize decodeBox = QSize());
+	void automaticLoad(
+		FileOrigin origin,
+		not_null<PeerData*> peer,
+		QSize decodeBox = QSize());
 
 	void collectLocalData(not_null<PhotoMedia*> local);
 
@@ -54,17 +70,31 @@ private:
 	struct PhotoImage {
 		std::unique_ptr<Image> data;
 		QByteArray bytes;
+		QSize size;
+		QSize decodeBox;
 		PhotoSize goodFor = PhotoSize();
+		DecodedImageCache::Entry cached;
+		bool decoding = false;
+
+		[[nodiscard]] bool exists() const {
+			return data || !bytes.isEmpty();
+		}
 	};
 
-	const PhotoImage *resolveLoadedImage(PhotoSize size) const;
+	const PhotoImage *resolveLoadedImage(
+		PhotoSize size,
+		bool needDecoded = true) const;
+	Image *decoded(int index) const;
+	void decodeAsync(int index, QSize box) const;
+	void decodeLarger(int index, QSize box);
+	void trackDecoded(int index) const;
 
 	// NB! Right now DocumentMedia can outlive Main::Session!
 	// In DocumentData::collectLocalData a shared_ptr is sent on_main.
 	// In case this is a problem the ~Gif code should be rewritten.
 	const not_null<PhotoData*> _owner;
 	mutable std::unique_ptr<Image> _inlineThumbnail;
-	std::array<PhotoImage, kPhotoSizeCount> _images;
+	mutable std::array<PhotoImage, kPhotoSizeCount> _images;
 	QByteArray _videoBytesSmall;
 	QByteArray _videoBytesLarge;
 
@@ -31,6 +31,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_element.h"
 #include "inline_bots/inline_bot_layout_item.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_deduplicator.h"
+#include "storage/storage_cache_policy.h"
 #include "storage/storage_encrypted_file.h"
 #include "media/player/media_player_instance.h" // instance()->play()
 #include "media/audio/media_audio.h"
@@ -69,6 +71,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_stories.h"
 #include "data/data_streaming.h"
 #include "data/data_media_rotation.h"
+#include "data/data_waveform_counter.h"
 #include "data/data_histories.h"
 #include "data/data_peer_values.h"
 #include "data/data_premium_limits.h"
@@ -218,6 +221,10 @@ Session::Session(not_null<Main::Session*> session)
 , _bigFileCache(Core::App().databases().get(
 	_session->local().cacheBigFilePath(),
 	_session->local().cacheBigFileSettings()))
+, _cacheDeduplicator(
+	std::make_unique<Storage::CacheDeduplicator>(_cache.get()))
+, _cachePolicy(
+	std::make_unique<Storage::CachePolicy>(_cacheDeduplicator.get()))
 , _groupFreeTranscribeLevel(session->appConfig().value(
 ) | rpl::map([limits = Data::LevelLimits(session)] {
 	return limits.groupTranscribeLevelMin();
@@ -238,6 +245,7 @@ Session::Session(not_null<Main::Session*> session)
 , _sendActionManager(std::make_unique<SendActionManager>())
 , _streaming(std::make_unique<Streaming>(this))
 , _mediaRotation(std::make_unique<MediaRotation>())
+, _waveformCounter(std::make_unique<WaveformCounter>(this))
 , _histories(std::make_unique<Histories>(this))
 , _stickers(std::make_unique<Stickers>(this))
 , _reactions(std::make_unique<Reactions>(this))
@@ -1352,6 +1360,14 @@ Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
 
+Storage::CacheDeduplicator &Session::cacheDeduplicator() {
+	return *_cacheDeduplicator;
+}
+
+Storage::CachePolicy &Session::cachePolicy() {
+	return *_cachePolicy;
+}
+
 void Session::suggestStartExport(TimeId availableAt) {
 	_exportAvailableAt = availableAt;
 	suggestStartExport();
@@ -1776,11 +1792,21 @@ rpl::producer<not_null<const HistoryItem*>> Session::itemRepaintRequest() const
 	return _itemRepaintRequest.events();
 }
 
-void Session::requestViewRepaint(not_null<const ViewElement*> view) {
-	_viewRepaintRequest.fire_copy(view);
+void Session::requestViewRepaint(
+		not_null<const ViewElement*> view,
+		QRect rect) {
+	_viewRepaintRequest.fire({ view, rect });
 }
 
 rpl::producer<not_null<const ViewElement*>> Session::viewRepaintRequest() const {
+	return _viewRepaintRequest.events(
+	) | rpl::map([](const ViewRepaintRequest &request) {
+		return request.view;
+	});
+}
+
+auto Session::viewRepaintRectRequest() const
+-> rpl::producer<ViewRepaintRequest> {
 	return _viewRepaintRequest.events();
 }
 
@@ -31,6 +31,11 @@ namespace Main {
 class Session;
 } // namespace Main
 
+namespace Storage {
+class CacheDeduplicator;
+class CachePolicy;
+} // namespace Storage
+
 namespace Ui {
 class BoxContent;
 } // namespace Ui
@@ -57,6 +62,7 @@ class ChatFilters;
 class CloudThemes;
 class Streaming;
 class MediaRotation;
+class WaveformCounter;
 class Histories;
 class DocumentMedia;
 class PhotoMedia;
@@ -99,6 +105,11 @@ struct SentFromScheduled {
 	MsgId sentId = 0;
 };
 
+struct ViewRepaintRequest {
+	not_null<const HistoryView::Element*> view;
+	QRect rect; // In view coordinates, null for the whole view.
+};
+
 class Session final {
 public:
 	using ViewElement = HistoryView::Element;
@@ -139,6 +150,9 @@ public:
 	[[nodiscard]] MediaRotation &mediaRotation() const {
 		return *_mediaRotation;
 	}
+	[[nodiscard]] WaveformCounter &waveformCounter() const {
+		return *_waveformCounter;
+	}
 	[[nodiscard]] Histories &histories() const {
 		return *_histories;
 	}
@@ -195,6 +209,8 @@ public:
 
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
+	[[nodiscard]] Storage::CacheDeduplicator &cacheDeduplicator();
+	[[nodiscard]] Storage::CachePolicy &cachePolicy();
 
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
@@ -305,8 +321,12 @@ public:
 	[[nodiscard]] rpl::producer<GiftUpdate> giftUpdates() const;
 	void requestItemRepaint(not_null<const HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemRepaintRequest() const;
-	void requestViewRepaint(not_null<const ViewElement*> view);
+	void requestViewRepaint(
+		not_null<const ViewElement*> view,
+		QRect rect = QRect());
 	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewRepaintRequest() const;
+	[[nodiscard]] auto viewRepaintRectRequest() const
+		-> rpl::producer<ViewRepaintRequest>;
 	void requestItemResize(not_null<const HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemResizeRequest() const;
 	void requestViewResize(not_null<ViewElement*> view);
@@ -945,6 +965,8 @@ private:
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	const std::unique_ptr<Storage::CacheDeduplicator> _cacheDeduplicator;
+	const std::unique_ptr<Storage::CachePolicy> _cachePolicy;
 
 	TimeId _exportAvailableAt = 0;
 	QPointer<Ui::BoxContent> _exportSuggestion;
@@ -962,7 +984,7 @@ private:
 	rpl::event_stream<not_null<HistoryItem*>> _newItemAdded;
 	rpl::event_stream<GiftUpdate> _giftUpdates;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemRepaintRequest;
-	rpl::event_stream<not_null<const ViewElement*>> _viewRepaintRequest;
+	rpl::event_stream<ViewRepaintRequest> _viewRepaintRequest;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemResizeRequest;
 	rpl::event_stream<not_null<ViewElement*>> _viewResizeRequest;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemViewRefreshRequest;
@@ -1127,6 +1149,7 @@ private:
 	const std::unique_ptr<SendActionManager> _sendActionManager;
 	const std::unique_ptr<Streaming> _streaming;
 	const std::unique_ptr<MediaRotation> _mediaRotation;
+	const std::unique_ptr<WaveformCounter> _waveformCounter;
 	const std::unique_ptr<Histories> _histories;
 	const std::unique_ptr<Stickers> _stickers;
 	const std::unique_ptr<Reactions> _reactions;
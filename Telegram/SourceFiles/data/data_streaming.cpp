@@ -144,6 +144,12 @@ template <typename Data>
 	if (!PruneDestroyedAndSet(documents, data, result)) {
 		documents.emplace_or_assign(data, result);
 	}
+	if (Logs::DebugEnabled()) {
+		const auto now = counters();
+		DEBUG_LOG(("Streaming Info: %1 decoders for %2 surfaces."
+			).arg(now.decoders
+			).arg(now.surfaces));
+	}
 	return result;
 }
 
@@ -231,6 +237,23 @@ void Streaming::keepAlive(not_null<PhotoData*> photo) {
 	keepAlive(_photoDocuments, photo);
 }
 
+auto Streaming::counters() const -> Counters {
+	auto result = Counters();
+	const auto add = [&](const auto &documents) {
+		for (const auto &[data, weak] : documents) {
+			if (const auto document = weak.lock()) {
+				if (document->player().active()) {
+					++result.decoders;
+				}
+				result.surfaces += document->instancesCount();
+			}
+		}
+	};
+	add(_fileDocuments);
+	add(_photoDocuments);
+	return result;
+}
+
 void Streaming::clearKeptAlive() {
 	const auto now = crl::now();
 	auto min = std::numeric_limits<crl::time>::max();
@@ -56,6 +56,13 @@ public:
 	void keepAlive(not_null<DocumentData*> document);
 	void keepAlive(not_null<PhotoData*> photo);
 
+	// All the surfaces of one document share a single decoder.
+	struct Counters {
+		int decoders = 0;
+		int surfaces = 0;
+	};
+	[[nodiscard]] Counters counters() const;
+
 private:
 	void clearKeptAlive();
 
@@ -19,9 +19,12 @@ constexpr auto kDocumentCacheMask = 0x00000000000000FFULL;
 constexpr auto kDocumentThumbCacheTag = 0x0000000000000200ULL;
 constexpr auto kDocumentThumbCacheMask = 0x00000000000000FFULL;
 constexpr auto kAudioAlbumThumbCacheTag = 0x0000000000000300ULL;
+constexpr auto kDocumentWaveformCacheTag = 0x0000000000000400ULL;
+constexpr auto kDocumentWaveformCacheMask = 0x00000000000000FFULL;
 constexpr auto kWebDocumentCacheTag = 0x0000020000000000ULL;
 constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
+constexpr auto kContentHashCacheTag = 0x0000050000000000ULL;
 
 } // namespace
 
@@ -40,6 +43,14 @@ Storage::Cache::Key DocumentThumbCacheKey(int32 dcId, uint64 id) {
 	};
 }
 
+Storage::Cache::Key DocumentWaveformCacheKey(int32 dcId, uint64 id) {
+	const auto part = (uint64(dcId) & Data::kDocumentWaveformCacheMask);
+	return Storage::Cache::Key{
+		Data::kDocumentWaveformCacheTag | part,
+		id
+	};
+}
+
 Storage::Cache::Key WebDocumentCacheKey(const WebFileLocation &location) {
 	const auto CacheDcId = 4; // The default production value. Doesn't matter.
 	const auto dcId = uint64(CacheDcId) & 0xFFULL;
@@ -95,6 +106,19 @@ Storage::Cache::Key AudioAlbumThumbCacheKey(
 	};
 }
 
+Storage::Cache::Key ContentHashCacheKey(const QByteArray &hash) {
+	if (hash.size() < sizeof(uint32) + sizeof(uint64)) {
+		return Storage::Cache::Key{ Data::kContentHashCacheTag, 0 };
+	}
+	const auto part1 = *reinterpret_cast<const uint32*>(hash.data());
+	const auto part2 = *reinterpret_cast<const uint64*>(
+		hash.data() + sizeof(uint32));
+	return Storage::Cache::Key{
+		Data::kContentHashCacheTag | part1,
+		part2
+	};
+}
+
 } // namespace Data
 
 void MessageCursor::fillFrom(not_null<const Ui::InputField*> field) {
@@ -0,0 +1,155 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_waveform_counter.h"
+
+#include "core/file_location.h"
+#include "data/data_document.h"
+#include "data/data_document_media.h"
+#include "data/data_session.h"
+#include "media/audio/media_audio.h"
+#include "storage/cache/storage_cache_database.h"
+
+#include <QtCore/QThread>
+
+namespace Data {
+namespace {
+
+[[nodiscard]] int MaxRunning() {
+	return std::clamp(QThread::idealThreadCount() / 2, 1, 4);
+}
+
+[[nodiscard]] QByteArray Serialize(const VoiceWaveform &waveform) {
+	return QByteArray(
+		reinterpret_cast<const char*>(waveform.constData()),
+		waveform.size());
+}
+
+[[nodiscard]] VoiceWaveform Deserialize(const QByteArray &serialized) {
+	auto result = VoiceWaveform(serialized.size());
+	memcpy(result.data(), serialized.constData(), serialized.size());
+	return ranges::any_of(result, [](auto value) { return value < 0; })
+		? VoiceWaveform()
+		: result;
+}
+
+} // namespace
+
+WaveformCounter::WaveformCounter(not_null<Session*> owner)
+: _owner(owner) {
+}
+
+WaveformCounter::~WaveformCounter() = default;
+
+void WaveformCounter::request(not_null<DocumentData*> document) {
+	const auto voice = document->voice();
+	if (!voice) {
+		return;
+	} else if (!voice->waveform.isEmpty()) {
+		if (voice->waveform[0] == kWaveformCounting) {
+			const auto i = _jobs.find(document);
+			if (i != end(_jobs)) {
+				i->second.priority = ++_priority;
+			}
+		}
+		return;
+	}
+	voice->waveform.resize(1);
+	voice->waveform[0] = kWaveformCounting;
+	_jobs.emplace(document, Job{ .priority = ++_priority });
+	checkCache(document);
+}
+
+void WaveformCounter::checkCache(not_null<DocumentData*> document) {
+	const auto weak = base::make_weak(this);
+	_owner->cache().get(document->waveformCacheKey(), [=](
+			QByteArray &&value) {
+		crl::on_main(weak, [=, value = std::move(value)] {
+			const auto cached = Deserialize(value);
+			if (!cached.isEmpty()) {
+				_jobs.remove(document);
+				apply(document, cached);
+				return;
+			}
+			const auto i = _jobs.find(document);
+			if (i != end(_jobs)) {
+				i->second.queued = true;
+				startNext();
+			}
+		});
+	});
+}
+
+void WaveformCounter::startNext() {
+	while (_running < MaxRunning()) {
+		auto next = end(_jobs);
+		for (auto i = begin(_jobs); i != end(_jobs); ++i) {
+			if (i->second.queued
+				&& (next == end(_jobs)
+					|| next->second.priority < i->second.priority)) {
+				next = i;
+			}
+		}
+		if (next == end(_jobs)) {
+			return;
+		}
+		const auto document = next->first;
+		_jobs.erase(next);
+		start(document);
+	}
+}
+
+void WaveformCounter::start(not_null<DocumentData*> document) {
+	const auto media = document->activeMediaView();
+	auto bytes = media ? media->bytes() : QByteArray();
+	auto location = document->location(true);
+	if (bytes.isEmpty() && !location.accessEnable()) {
+		apply(document, VoiceWaveform());
+		return;
+	}
+	++_running;
+	crl::async([
+		=,
+		weak = base::make_weak(this),
+		bytes = std::move(bytes),
+		location = std::move(location)
+	]() mutable {
+		auto waveform = audioCountWaveform(location, bytes);
+		if (bytes.isEmpty()) {
+			location.accessDisable();
+		}
+		crl::on_main(weak, [=, waveform = std::move(waveform)] {
+			--_running;
+			if (!waveform.isEmpty()) {
+				_owner->cache().put(
+					document->waveformCacheKey(),
+					Serialize(waveform));
+			}
+			apply(document, waveform);
+			startNext();
+		});
+	});
+}
+
+void WaveformCounter::apply(
+		not_null<DocumentData*> document,
+		const VoiceWaveform &waveform) {
+	const auto voice = document->voice();
+	if (!voice) {
+		return;
+	} else if (!waveform.isEmpty()) {
+		voice->waveform = waveform;
+		voice->wavemax = *ranges::max_element(waveform);
+	} else if (voice->waveform.isEmpty() || voice->waveform[0] < 0) {
+		voice->waveform.resize(1);
+		voice->waveform[0] = kWaveformFailed;
+		voice->wavemax = 0;
+	}
+	_owner->requestDocumentViewRepaint(document);
+}
+
+} // namespace Data
@@ -0,0 +1,55 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+class DocumentData;
+
+namespace Data {
+
+class Session;
+
+// Values of the first waveform sample while it is not counted yet.
+inline constexpr auto kWaveformCounting = char(-1);
+inline constexpr auto kWaveformFailed = char(-2);
+
+// Counts waveforms of the voice messages that came without one.
+//
+// Counted waveforms are kept in the media cache. Files are decoded in
+// a few background threads at once, the most recently requested (that
+// is, the most recently painted) documents go first.
+class WaveformCounter final : public base::has_weak_ptr {
+public:
+	explicit WaveformCounter(not_null<Session*> owner);
+	~WaveformCounter();
+
+	// The file must be already loaded.
+	void request(not_null<DocumentData*> document);
+
+private:
+	struct Job {
+		uint64 priority = 0;
+		bool queued = false;
+	};
+
+	void checkCache(not_null<DocumentData*> document);
+	void startNext();
+	void start(not_null<DocumentData*> document);
+	void apply(
+		not_null<DocumentData*> document,
+		const VoiceWaveform &waveform);
+
+	const not_null<Session*> _owner;
+	base::flat_map<not_null<DocumentData*>, Job> _jobs;
+	uint64 _priority = 0;
+	int _running = 0;
+
+};
+
+} // namespace Data
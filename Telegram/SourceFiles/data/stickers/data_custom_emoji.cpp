@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "boxes/peers/edit_forum_topic_box.h" // MakeTopicIconEmoji.
 #include "chat_helpers/stickers_emoji_pack.h"
+#include "core/application.h"
 #include "main/main_app_config.h"
 #include "main/main_session.h"
 #include "data/data_channel.h"
@@ -19,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_forum_topic.h" // ParseTopicIconEmojiEntity.
 #include "data/data_peer.h"
 #include "data/data_message_reactions.h"
+#include "data/stickers/data_custom_emoji_atlas.h"
 #include "data/stickers/data_stickers.h"
 #include "dialogs/ui/dialogs_stories_content.h"
 #include "dialogs/ui/dialogs_stories_content.h"
@@ -177,6 +179,9 @@ private:
 	void startCacheLookup(
 		not_null<Lookup*> lookup,
 		Fn<void(LoadResult)> loaded);
+	void lookupLocalCache(not_null<Lookup*> lookup);
+	[[nodiscard]] Fn<void(QByteArray)> deserializer(
+		not_null<Lookup*> lookup);
 	void lookupDone(
 		not_null<Lookup*> lookup,
 		std::optional<Ui::CustomEmoji::Cache> result);
@@ -305,23 +310,60 @@ Storage::Cache::Key CustomEmojiLoader::cacheKey(
 void CustomEmojiLoader::startCacheLookup(
 		not_null<Lookup*> lookup,
 		Fn<void(LoadResult)> loaded) {
+	lookup->process = std::make_unique<Process>(Process{
+		.loaded = std::move(loaded),
+	});
+
+	// Frames rendered by any account are shared through the atlas.
+	auto &atlas = Core::App().customEmojiAtlas();
+	const auto atlasKey = CustomEmojiFrameAtlas::Key{
+		lookup->document->id,
+		FrameSizeFromTag(_tag, _sizeOverride),
+	};
+	const auto weak = base::make_weak(&lookup->process->guard);
+	if (auto shared = atlas.lookup(atlasKey); !shared.isEmpty()) {
+		crl::async([=, done = deserializer(lookup)] {
+			done(shared);
+		});
+	} else if (!atlas.wait(atlasKey, crl::guard(weak, [=](
+			QByteArray value) {
+		if (value.isEmpty()) {
+			lookupLocalCache(lookup);
+		} else {
+			crl::async([=, done = deserializer(lookup)] {
+				done(value);
+			});
+		}
+	}))) {
+		lookupLocalCache(lookup);
+	}
+}
+
+void CustomEmojiLoader::lookupLocalCache(not_null<Lookup*> lookup) {
+	Expects(lookup->process != nullptr);
+
 	const auto document = lookup->document;
 	const auto key = cacheKey(document);
 	if (!key) {
-		loadNoCache(document, std::move(loaded));
+		lookupDone(lookup, std::nullopt);
 		return;
 	}
-	lookup->process = std::make_unique<Process>(Process{
-		.loaded = std::move(loaded),
-	});
+	document->owner().cacheBigFile().get(key, deserializer(lookup));
+}
+
+Fn<void(QByteArray)> CustomEmojiLoader::deserializer(
+		not_null<Lookup*> lookup) {
+	Expects(lookup->process != nullptr);
+
+	// Called in the thread that has the serialized frames.
 	const auto size = FrameSizeFromTag(_tag, _sizeOverride);
 	const auto weak = base::make_weak(&lookup->process->guard);
-	document->owner().cacheBigFile().get(key, [=](QByteArray value) {
+	return [=](QByteArray value) {
 		auto cache = Ui::CustomEmoji::Cache::FromSerialized(value, size);
 		crl::on_main(weak, [=, result = std::move(cache)]() mutable {
 			lookupDone(lookup, std::move(result));
 		});
-	});
+	};
 }
 
 void CustomEmojiLoader::lookupDone(
@@ -379,7 +421,14 @@ void CustomEmojiLoader::check() {
 			tag,
 			sizeOverride);
 	};
-	auto put = [=, key = cacheKey(document)](QByteArray value) {
+	auto &atlas = Core::App().customEmojiAtlas();
+	const auto atlasKey = CustomEmojiFrameAtlas::Key{ document->id, size };
+	const auto render = atlas.startRender(atlasKey);
+	auto put = [=, key = cacheKey(document), weak = base::make_weak(&atlas)](
+			QByteArray value) {
+		crl::on_main(weak, [=] {
+			weak->put(atlasKey, value);
+		});
 		const auto size = value.size();
 		if (size <= Storage::kMaxFileInMemory) {
 			document->owner().cacheBigFile().put(key, std::move(value));
@@ -390,15 +439,18 @@ void CustomEmojiLoader::check() {
 	const auto type = document->sticker()->type;
 	auto generator = [=, bytes = Lottie::ReadContent(data, filepath)]()
 	-> std::unique_ptr<Ui::FrameGenerator> {
-		switch (type) {
-		case StickerType::Tgs:
-			return std::make_unique<Lottie::FrameGenerator>(bytes);
-		case StickerType::Webm:
-			return std::make_unique<FFmpeg::FrameGenerator>(bytes);
-		case StickerType::Webp:
-			return std::make_unique<Ui::ImageFrameGenerator>(bytes);
-		}
-		Unexpected("Type in custom emoji sticker frame generator.");
+		const auto make = [&]() -> std::unique_ptr<Ui::FrameGenerator> {
+			switch (type) {
+			case StickerType::Tgs:
+				return std::make_unique<Lottie::FrameGenerator>(bytes);
+			case StickerType::Webm:
+				return std::make_unique<FFmpeg::FrameGenerator>(bytes);
+			case StickerType::Webp:
+				return std::make_unique<Ui::ImageFrameGenerator>(bytes);
+			}
+			Unexpected("Type in custom emoji sticker frame generator.");
+		};
+		return CustomEmojiFrameAtlas::Wrap(render, make());
 	};
 	auto renderer = std::make_unique<Renderer>(RendererDescriptor{
 		.generator = std::move(generator),
@@ -0,0 +1,311 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/stickers/data_custom_emoji_atlas.h"
+
+#include "base/call_delayed.h"
+#include "ui/effects/frame_generator.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kDefaultLimit = int64(32 * 1024 * 1024);
+constexpr auto kCheckRenderProgress = crl::time(200);
+constexpr auto kMaxDecodedFramesKeys = 1024;
+
+} // namespace
+
+class CustomEmojiFrameAtlas::Render final {
+public:
+	Render(not_null<CustomEmojiFrameAtlas*> owner, Key key);
+	~Render();
+
+	void frameDecoded();
+	[[nodiscard]] int frames() const;
+
+private:
+	const base::weak_ptr<CustomEmojiFrameAtlas> _owner;
+	const Key _key;
+	std::atomic<int> _frames = 0;
+
+};
+
+namespace {
+
+class CountingGenerator final : public Ui::FrameGenerator {
+public:
+	CountingGenerator(
+		std::shared_ptr<CustomEmojiFrameAtlas::Render> render,
+		std::unique_ptr<Ui::FrameGenerator> generator);
+
+	int count() override;
+	double rate() override;
+	Frame renderNext(
+		QImage storage,
+		QSize size,
+		Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio) override;
+	Frame renderCurrent(
+		QImage storage,
+		QSize size,
+		Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio) override;
+	void jumpToStart() override;
+
+private:
+	const std::shared_ptr<CustomEmojiFrameAtlas::Render> _render;
+	const std::unique_ptr<Ui::FrameGenerator> _generator;
+
+};
+
+CountingGenerator::CountingGenerator(
+	std::shared_ptr<CustomEmojiFrameAtlas::Render> render,
+	std::unique_ptr<Ui::FrameGenerator> generator)
+: _render(std::move(render))
+, _generator(std::move(generator)) {
+}
+
+int CountingGenerator::count() {
+	return _generator->count();
+}
+
+double CountingGenerator::rate() {
+	return _generator->rate();
+}
+
+auto CountingGenerator::renderNext(
+	QImage storage,
+	QSize size,
+	Qt::AspectRatioMode mode)
+-> Frame {
+	_render->frameDecoded();
+	return _generator->renderNext(std::move(storage), size, mode);
+}
+
+auto CountingGenerator::renderCurrent(
+	QImage storage,
+	QSize size,
+	Qt::AspectRatioMode mode)
+-> Frame {
+	return _generator->renderCurrent(std::move(storage), size, mode);
+}
+
+void CountingGenerator::jumpToStart() {
+	_generator->jumpToStart();
+}
+
+} // namespace
+
+CustomEmojiFrameAtlas::Render::Render(
+	not_null<CustomEmojiFrameAtlas*> owner,
+	Key key)
+: _owner(owner)
+, _key(key) {
+}
+
+CustomEmojiFrameAtlas::Render::~Render() {
+	// May be destroyed in the thread that was rendering the frames.
+	crl::on_main(_owner, [
+			owner = _owner,
+			key = _key,
+			frames = _frames.load()] {
+		owner->renderFinished(key, frames);
+	});
+}
+
+void CustomEmojiFrameAtlas::Render::frameDecoded() {
+	++_frames;
+}
+
+int CustomEmojiFrameAtlas::Render::frames() const {
+	return _frames.load();
+}
+
+CustomEmojiFrameAtlas::CustomEmojiFrameAtlas()
+: _limit(DefaultLimit()) {
+}
+
+CustomEmojiFrameAtlas::~CustomEmojiFrameAtlas() = default;
+
+int64 CustomEmojiFrameAtlas::DefaultLimit() {
+	return kDefaultLimit;
+}
+
+void CustomEmojiFrameAtlas::setLimit(int64 bytes) {
+	Expects(bytes >= 0);
+
+	_limit = bytes;
+	checkLimit();
+}
+
+QByteArray CustomEmojiFrameAtlas::lookup(Key key) {
+	const auto i = _entries.find(key);
+	if (i == end(_entries)) {
+		++_misses;
+		return QByteArray();
+	}
+	++_hits;
+	i->second.lastUsed = ++_lastUsed;
+	return i->second.serialized;
+}
+
+bool CustomEmojiFrameAtlas::wait(Key key, Fn<void(QByteArray)> done) {
+	Expects(done != nullptr);
+
+	const auto i = _rendering.find(key);
+	if (i == end(_rendering)) {
+		return false;
+	}
+	++_waits;
+	const auto id = ++_waiterId;
+	i->second.waiters.push_back({
+		.done = std::move(done),
+		.id = id,
+		.frames = FramesDecoded(i->second),
+	});
+	base::call_delayed(kCheckRenderProgress, this, [=] {
+		checkWaiter(key, id);
+	});
+	return true;
+}
+
+int CustomEmojiFrameAtlas::FramesDecoded(const Rendering &rendering) {
+	auto result = 0;
+	for (const auto &weak : rendering.renders) {
+		if (const auto strong = weak.lock()) {
+			result += strong->frames();
+		}
+	}
+	return result;
+}
+
+void CustomEmojiFrameAtlas::checkWaiter(Key key, uint64 id) {
+	const auto i = _rendering.find(key);
+	if (i == end(_rendering)) {
+		return;
+	}
+	auto &waiters = i->second.waiters;
+	const auto j = ranges::find(waiters, id, &Waiter::id);
+	if (j == end(waiters)) {
+		return;
+	}
+
+	// Keep waiting while the frames are being decoded, so that they are
+	// not decoded twice. Don't wait for a render that was paused.
+	const auto frames = FramesDecoded(i->second);
+	if (frames > j->frames) {
+		j->frames = frames;
+		base::call_delayed(kCheckRenderProgress, this, [=] {
+			checkWaiter(key, id);
+		});
+		return;
+	}
+	const auto done = std::move(j->done);
+	waiters.erase(j);
+	done(QByteArray());
+}
+
+auto CustomEmojiFrameAtlas::startRender(Key key)
+-> std::shared_ptr<Render> {
+	auto &rendering = _rendering[key];
+	auto result = std::make_shared<Render>(this, key);
+	++rendering.active;
+	rendering.renders.push_back(result);
+	return result;
+}
+
+std::unique_ptr<Ui::FrameGenerator> CustomEmojiFrameAtlas::Wrap(
+		std::shared_ptr<Render> render,
+		std::unique_ptr<Ui::FrameGenerator> generator) {
+	Expects(render != nullptr);
+	Expects(generator != nullptr);
+
+	return std::make_unique<CountingGenerator>(
+		std::move(render),
+		std::move(generator));
+}
+
+void CustomEmojiFrameAtlas::put(Key key, QByteArray serialized) {
+	if (serialized.isEmpty()) {
+		return;
+	}
+	auto &entry = _entries[key];
+	_bytes += serialized.size() - entry.serialized.size();
+	entry.serialized = serialized;
+	entry.lastUsed = ++_lastUsed;
+
+	const auto i = _rendering.find(key);
+	if (i != end(_rendering)) {
+		for (const auto &waiter : base::take(i->second.waiters)) {
+			waiter.done(serialized);
+		}
+	}
+	checkLimit();
+}
+
+void CustomEmojiFrameAtlas::renderFinished(Key key, int frames) {
+	++_renders;
+	_framesDecoded += frames;
+	if (_decodedFrames.size() >= kMaxDecodedFramesKeys
+		&& !_decodedFrames.contains(key)) {
+		_decodedFrames.clear();
+	}
+	const auto already = (_decodedFrames[key] += frames) - frames;
+	if (already > 0 && frames > 0) {
+		DEBUG_LOG(("Emoji Atlas: Frames of %1 (size %2) decoded again, "
+			"%3 frames total."
+			).arg(key.documentId
+			).arg(key.size
+			).arg(already + frames));
+	}
+
+	const auto i = _rendering.find(key);
+	if (i == end(_rendering) || --i->second.active > 0) {
+		return;
+	}
+	auto waiters = std::move(i->second.waiters);
+	_rendering.erase(i);
+
+	// If nothing was put the waiters will render the frames themselves.
+	const auto j = _entries.find(key);
+	const auto serialized = (j != end(_entries))
+		? j->second.serialized
+		: QByteArray();
+	for (const auto &waiter : waiters) {
+		waiter.done(serialized);
+	}
+}
+
+void CustomEmojiFrameAtlas::checkLimit() {
+	while (_bytes > _limit && !_entries.empty()) {
+		const auto i = ranges::min_element(
+			_entries,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.lastUsed; });
+		_bytes -= i->second.serialized.size();
+		_decodedFrames.remove(i->first);
+		_entries.erase(i);
+	}
+}
+
+int CustomEmojiFrameAtlas::decodedFrames(Key key) const {
+	const auto i = _decodedFrames.find(key);
+	return (i != end(_decodedFrames)) ? i->second : 0;
+}
+
+auto CustomEmojiFrameAtlas::stats() const -> Stats {
+	return {
+		.renders = _renders,
+		.framesDecoded = _framesDecoded,
+		.hits = _hits,
+		.misses = _misses,
+		.waits = _waits,
+		.bytes = _bytes,
+		.limit = _limit,
+		.entries = int(_entries.size()),
+	};
+}
+
+} // namespace Data
@@ -0,0 +1,106 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+namespace Ui {
+class FrameGenerator;
+} // namespace Ui
+
+namespace Data {
+
+// Rendered custom emoji frames shared between all CustomEmojiManager-s.
+//
+// Entries are serialized Ui::CustomEmoji::Cache-s keyed by the document
+// and the frame size in pixels, so the same emoji shown by several
+// accounts or size tags with equal frame size is decoded only once.
+// While some loader renders the frames other loaders of the same key
+// wait for the result instead of starting their own decoding.
+class CustomEmojiFrameAtlas final : public base::has_weak_ptr {
+public:
+	struct Key {
+		DocumentId documentId = 0;
+		int size = 0;
+
+		friend inline auto operator<=>(Key, Key) = default;
+	};
+	struct Stats {
+		int64 renders = 0;
+		int64 framesDecoded = 0;
+		int64 hits = 0;
+		int64 misses = 0;
+		int64 waits = 0;
+		int64 bytes = 0;
+		int64 limit = 0;
+		int entries = 0;
+	};
+
+	// Holds the key in the "rendering" state until destroyed.
+	class Render;
+
+	CustomEmojiFrameAtlas();
+	~CustomEmojiFrameAtlas();
+
+	[[nodiscard]] static int64 DefaultLimit();
+	void setLimit(int64 bytes);
+
+	[[nodiscard]] QByteArray lookup(Key key);
+
+	// Returns false if nobody renders this key right now.
+	// Otherwise done() is called with the rendered frames or with
+	// an empty byte array if the rendering was cancelled or stalled,
+	// then the waiter renders them itself.
+	bool wait(Key key, Fn<void(QByteArray)> done);
+
+	[[nodiscard]] std::shared_ptr<Render> startRender(Key key);
+	[[nodiscard]] static std::unique_ptr<Ui::FrameGenerator> Wrap(
+		std::shared_ptr<Render> render,
+		std::unique_ptr<Ui::FrameGenerator> generator);
+	void put(Key key, QByteArray serialized);
+
+	[[nodiscard]] int decodedFrames(Key key) const;
+	[[nodiscard]] Stats stats() const;
+
+private:
+	struct Entry {
+		QByteArray serialized;
+		uint64 lastUsed = 0;
+	};
+	struct Waiter {
+		Fn<void(QByteArray)> done;
+		uint64 id = 0;
+		int frames = 0;
+	};
+	struct Rendering {
+		std::vector<Waiter> waiters;
+		std::vector<std::weak_ptr<Render>> renders;
+		int active = 0;
+	};
+
+	void renderFinished(Key key, int frames);
+	void checkWaiter(Key key, uint64 id);
+	[[nodiscard]] static int FramesDecoded(const Rendering &rendering);
+	void checkLimit();
+
+	base::flat_map<Key, Entry> _entries;
+	base::flat_map<Key, Rendering> _rendering;
+	base::flat_map<Key, int> _decodedFrames;
+	uint64 _lastUsed = 0;
+	uint64 _waiterId = 0;
+	int64 _bytes = 0;
+	int64 _limit = 0;
+	int64 _renders = 0;
+	int64 _framesDecoded = 0;
+	int64 _hits = 0;
+	int64 _misses = 0;
+	int64 _waits = 0;
+
+};
+
+} // namespace Data
@@ -181,6 +181,16 @@ rpl::producer<> Stickers::savedGifsUpdated() const {
 	return _savedGifsUpdated.events();
 }
 
+const SavedGifs &Stickers::savedGifs() const {
+	session().local().readSavedGifs();
+	return _savedGifs;
+}
+
+SavedGifs &Stickers::savedGifsRef() {
+	session().local().readSavedGifs();
+	return _savedGifs;
+}
+
 void Stickers::notifyStickerSetInstalled(uint64 setId) {
 	_stickerSetInstalled.fire(std::move(setId));
 }
@@ -312,18 +322,20 @@ void Stickers::incrementSticker(not_null<DocumentData*> document) {
 void Stickers::addSavedGif(
 		std::shared_ptr<ChatHelpers::Show> show,
 		not_null<DocumentData*> document) {
-	const auto index = _savedGifs.indexOf(document);
+	// Read the saved list first, so that it doesn't replace our change.
+	auto &saved = savedGifsRef();
+	const auto index = saved.indexOf(document);
 	if (!index) {
 		return;
 	}
 	if (index > 0) {
-		_savedGifs.remove(index);
+		saved.remove(index);
 	}
-	_savedGifs.push_front(document);
+	saved.push_front(document);
 	const auto session = &document->session();
 	const auto limits = Data::PremiumLimits(session);
-	if (_savedGifs.size() > limits.gifsCurrent()) {
-		_savedGifs.pop_back();
+	if (saved.size() > limits.gifsCurrent()) {
+		saved.pop_back();
 		MaybeShowPremiumToast(
 			show,
 			SavedGifsToast(limits),
@@ -716,7 +728,9 @@ void Stickers::somethingReceived(
 		if (!(set->flags & SetFlag::Archived)
 			|| (set->flags & SetFlag::Official)) {
 			setsOrder.push_back(set->id);
-			if (set->stickers.isEmpty()
+			const auto pending = session().local().hasPendingStickerSet(
+				set->id);
+			if ((set->stickers.isEmpty() && !pending)
 				|| (set->flags & SetFlag::NotLoaded)) {
 				setsToRequest.insert(set->id, set->accessHash);
 			}
@@ -1038,7 +1052,11 @@ void Stickers::featuredReceived(
 			set->flags = flags
 				| (set->flags & (SetFlag::NotLoaded | SetFlag::Special));
 			set->installDate = installDate;
-			if (set->count != data->vcount().v || set->hash != data->vhash().v || set->emoji.empty()) {
+			const auto pending = session().local().hasPendingStickerSet(
+				set->id);
+			if (set->count != data->vcount().v
+				|| set->hash != data->vhash().v
+				|| (set->emoji.empty() && !pending)) {
 				set->count = data->vcount().v;
 				set->hash = data->vhash().v;
 				set->flags |= SetFlag::NotLoaded; // need to request this set
@@ -1047,7 +1065,9 @@ void Stickers::featuredReceived(
 		it->second->setThumbnail(thumbnail, thumbnailType);
 		it->second->thumbnailDocumentId = data->vthumb_document_id().value_or_empty();
 		featuredOrder.push_back(data->vid().v);
-		if (it->second->stickers.isEmpty()
+		const auto pending = session().local().hasPendingStickerSet(
+			it->second->id);
+		if ((it->second->stickers.isEmpty() && !pending)
 			|| (it->second->flags & SetFlag::NotLoaded)) {
 			setsToRequest.emplace(data->vid().v, data->vaccess_hash().v);
 		}
@@ -1130,6 +1150,9 @@ void Stickers::gifsReceived(const QVector<MTPDocument> &items, uint64 hash) {
 }
 
 std::vector<not_null<DocumentData*>> Stickers::getPremiumList(uint64 seed) {
+	// Premium stickers of the regular sets are read from storage lazily.
+	session().local().readPendingStickerSets();
+
 	struct StickerWithDate {
 		not_null<DocumentData*> document;
 		TimeId date = 0;
@@ -1265,6 +1288,9 @@ std::vector<not_null<DocumentData*>> Stickers::getListByEmoji(
 		std::vector<EmojiPtr> emoji,
 		uint64 seed,
 		bool forceAllResults) {
+	// Emoji packs of the regular sets are read from storage lazily.
+	session().local().readPendingStickerSets();
+
 	auto all = base::flat_set<EmojiPtr>();
 	for (const auto &one : emoji) {
 		all.emplace(one->original());
@@ -1591,7 +1617,8 @@ not_null<StickersSet*> Stickers::feedSet(const MTPStickerSet &info) {
 			: TimeId(0);
 		if (set->count != data.vcount().v
 			|| set->hash != data.vhash().v
-			|| set->emoji.empty()) {
+			|| (set->emoji.empty()
+				&& !session().local().hasPendingStickerSet(set->id))) {
 			// Need to request this data.
 			set->count = data.vcount().v;
 			set->hash = data.vhash().v;
@@ -197,12 +197,9 @@ public:
 	[[nodiscard]] StickersSetsOrder &archivedMaskSetsOrderRef() {
 		return _archivedMaskSetsOrder;
 	}
-	[[nodiscard]] const SavedGifs &savedGifs() const {
-		return _savedGifs;
-	}
-	[[nodiscard]] SavedGifs &savedGifsRef() {
-		return _savedGifs;
-	}
+	// Saved GIFs are read from the local storage on the first access.
+	[[nodiscard]] const SavedGifs &savedGifs() const;
+	[[nodiscard]] SavedGifs &savedGifsRef();
 	void removeFromRecentSet(not_null<DocumentData*> document);
 
 	void addSavedGif(
@@ -91,6 +91,18 @@ constexpr auto kHashtagResultsLimit = 5;
 constexpr auto kStartReorderThreshold = 30;
 constexpr auto kQueryPreviewLimit = 32;
 constexpr auto kPreviewPostsLimit = 3;
+constexpr auto kRowCachesLimit = 64;
+
+// Rows invalidated this soon after rendering are animating, so caching
+// them only adds an extra blit, paint them directly for a while.
+constexpr auto kRowCacheMinLifetime = crl::time(300);
+constexpr auto kRowCacheSkipDuration = crl::time(2000);
+
+base::options::toggle OptionDialogsRowCache({
+	.id = kOptionDialogsRowCache,
+	.name = "Cache chats list rows",
+	.description = "Reuse rendered chats list rows between repaints.",
+});
 
 [[nodiscard]] InnerWidget::ChatsFilterTagsKey SerializeFilterTagsKey(
 		FilterId filterId,
@@ -223,6 +235,8 @@ constexpr auto kPreviewPostsLimit = 3;
 
 } // namespace
 
+const char kOptionDialogsRowCache[] = "dialogs-row-cache";
+
 struct InnerWidget::CollapsedRow {
 	CollapsedRow(Data::Folder *folder) : folder(folder) {
 	}
@@ -281,10 +295,13 @@ InnerWidget::InnerWidget(
 	) | rpl::start_with_next([=] {
 		_topicJumpCache = nullptr;
 		_chatsFilterTags.clear();
+		_rowCaches.clear();
 	}, lifetime());
 
 	session().downloaderTaskFinished(
 	) | rpl::start_with_next([=] {
+		// Userpics and media previews could've been loaded.
+		_rowCaches.clear();
 		update();
 	}, lifetime());
 
@@ -292,6 +309,7 @@ InnerWidget::InnerWidget(
 	) | rpl::start_with_next([=](Window::Notifications::ChangeType change) {
 		if (change == Window::Notifications::ChangeType::CountMessages) {
 			// Folder rows change their unread badge with this setting.
+			_rowCaches.clear();
 			update();
 		}
 	}, lifetime());
@@ -352,6 +370,7 @@ InnerWidget::InnerWidget(
 	) | rpl::start_with_next([=](bool refreshHeight) {
 		if (refreshHeight) {
 			_chatsFilterTags.clear();
+			_rowCaches.clear();
 		}
 		if (refreshHeight && _filterId) {
 			// Height of the main list will be refreshed in other way.
@@ -396,6 +415,7 @@ InnerWidget::InnerWidget(
 			const auto filterId = data.filterId;
 			const auto key = SerializeFilterTagsKey(filterId, 0, false);
 			const auto activeKey = SerializeFilterTagsKey(filterId, 0, true);
+			_rowCaches.clear();
 			{
 				auto &tags = _chatsFilterTags;
 				if (const auto it = tags.find(key); it != tags.end()) {
@@ -439,6 +459,7 @@ InnerWidget::InnerWidget(
 			stopReorderPinned();
 		}
 		if (update.flags & Data::HistoryUpdate::Flag::ChatOccupied) {
+			_rowCaches.clear();
 			this->update();
 			_updated.fire({});
 		}
@@ -913,7 +934,7 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 		context.topicJumpSelected = selected
 			&& _selectedTopicJump
 			&& (!_pressed || _pressedTopicJump);
-		Ui::RowPainter::Paint(p, row, validateVideoUserpic(row), context);
+		paintRowCached(p, row, validateVideoUserpic(row), context);
 	};
 	if (_state == WidgetState::Default) {
 		const auto collapsedSkip = collapsedRowsOffset();
@@ -1336,6 +1357,86 @@ Ui::VideoUserpic *InnerWidget::validateVideoUserpic(
 	)).first->second.get();
 }
 
+void InnerWidget::paintRowCached(
+		Painter &p,
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context) {
+	const auto history = row->history();
+	if (!OptionDialogsRowCache.value()
+		|| videoUserpic
+		|| !history
+		|| history->isForum()
+		|| context.rightButton
+		|| context.topicsExpanded > 0.
+		|| _childListShown.current().shown > 0.
+		|| row->hasRipple()
+		|| row->topicJumpRipple()) {
+		Ui::RowPainter::Paint(p, row, videoUserpic, context);
+		return;
+	}
+	const auto ratio = style::DevicePixelRatio();
+	auto key = RowCacheKey{
+		.row = row.get(),
+		.st = context.st,
+		.chatsFilterTags = (context.chatsFilterTags
+			? *context.chatsFilterTags
+			: std::vector<QImage*>()),
+		.filter = context.filter,
+		.day = QDate::currentDate().toJulianDay(),
+		.width = context.width,
+		.height = row->height(),
+		.ratio = ratio,
+		.active = context.active,
+		.selected = context.selected,
+		.paused = context.paused,
+		.narrow = context.narrow,
+	};
+	if (!_rowCaches.contains(row->key())
+		&& _rowCaches.size() >= kRowCachesLimit) {
+		const auto oldest = ranges::min_element(
+			_rowCaches,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.used; });
+		_rowCaches.erase(oldest);
+	}
+	auto &cache = _rowCaches[row->key()];
+	cache.used = context.now;
+	if (cache.skipTill > context.now) {
+		Ui::RowPainter::Paint(p, row, nullptr, context);
+		return;
+	} else if (cache.image.isNull() || cache.key != key) {
+		const auto size = QSize(context.width, row->height());
+		if (cache.image.size() != size * ratio) {
+			cache.image = QImage(
+				size * ratio,
+				QImage::Format_ARGB32_Premultiplied);
+			cache.image.setDevicePixelRatio(ratio);
+		}
+		cache.image.fill(Qt::transparent);
+		{
+			Painter q(&cache.image);
+			q.setInactive(context.paused);
+			Ui::RowPainter::Paint(q, row, nullptr, context);
+		}
+		cache.key = std::move(key);
+		cache.rendered = context.now;
+	}
+	p.drawImage(0, 0, cache.image);
+}
+
+void InnerWidget::invalidateRowCache(Key key) {
+	const auto i = _rowCaches.find(key);
+	if (i == end(_rowCaches) || i->second.image.isNull()) {
+		return;
+	}
+	const auto now = crl::now();
+	if (now - i->second.rendered < kRowCacheMinLifetime) {
+		i->second.skipTill = now + kRowCacheSkipDuration;
+	}
+	i->second.image = QImage();
+}
+
 void InnerWidget::paintCollapsedRows(Painter &p, QRect clip) const {
 	auto index = 0;
 	const auto rowHeight = st::dialogsImportantBarHeight;
@@ -2359,6 +2460,7 @@ void InnerWidget::setSearchedPressed(int pressed) {
 }
 
 void InnerWidget::resizeEvent(QResizeEvent *e) {
+	_rowCaches.clear();
 	if (_searchTags) {
 		_searchTags->resizeToWidth(width() - 2 * _searchTagsLeft);
 	}
@@ -2380,6 +2482,7 @@ void InnerWidget::moveSearchIn() {
 void InnerWidget::dialogRowReplaced(
 		Row *oldRow,
 		Row *newRow) {
+	_rowCaches.clear();
 	auto found = false;
 	if (_state == WidgetState::Filtered) {
 		auto top = 0;
@@ -2506,6 +2609,7 @@ int InnerWidget::defaultRowTop(not_null<Row*> row) const {
 void InnerWidget::repaintDialogRow(
 		FilterId filterId,
 		not_null<Row*> row) {
+	invalidateRowCache(row->key());
 	if (_state == WidgetState::Default) {
 		if (_filterId == filterId) {
 			if (const auto folder = row->folder()) {
@@ -2578,6 +2682,7 @@ void InnerWidget::updateDialogRow(
 			}
 		}
 	}
+	invalidateRowCache(row.key);
 
 	const auto updateRow = [&](int rowTop, int rowHeight) {
 		if (!updateRect.isEmpty()) {
@@ -3580,6 +3685,7 @@ void InnerWidget::editOpenedFilter() {
 }
 
 void InnerWidget::refresh(bool toTop) {
+	_rowCaches.clear();
 	if (!_geometryInited) {
 		return;
 	} else if (needCollapsedRowsRefresh()) {
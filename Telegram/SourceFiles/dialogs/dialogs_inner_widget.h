@@ -67,6 +67,8 @@ enum class HashOrCashtag : uchar;
 struct RightButton;
 enum class ChatTypeFilter : uchar;
 
+extern const char kOptionDialogsRowCache[];
+
 struct ChosenRow {
 	Key key;
 	Data::MessagePosition message;
@@ -247,6 +249,33 @@ private:
 		crl::time animStartTime = 0;
 	};
 
+	struct RowCacheKey {
+		const Row *row = nullptr;
+		const style::DialogRow *st = nullptr;
+		std::vector<QImage*> chatsFilterTags;
+		FilterId filter = 0;
+		int64 day = 0;
+		int width = 0;
+		int height = 0;
+		int ratio = 0;
+		bool active = false;
+		bool selected = false;
+		bool paused = false;
+		bool narrow = false;
+
+		friend inline bool operator==(
+			const RowCacheKey &a,
+			const RowCacheKey &b) = default;
+	};
+
+	struct RowCache {
+		RowCacheKey key;
+		QImage image;
+		crl::time rendered = 0;
+		crl::time used = 0;
+		crl::time skipTill = 0;
+	};
+
 	struct FilterResult {
 		FilterResult(not_null<Row*> row) : row(row) {
 		}
@@ -384,6 +413,12 @@ private:
 	[[nodiscard]] int searchInChatSkip() const;
 	[[nodiscard]] int hashtagsOffset() const;
 
+	void paintRowCached(
+		Painter &p,
+		not_null<Row*> row,
+		Ui::VideoUserpic *videoUserpic,
+		const Ui::PaintContext &context);
+	void invalidateRowCache(Key key);
 	void paintCollapsedRows(
 		Painter &p,
 		QRect clip) const;
@@ -586,6 +621,7 @@ private:
 	base::flat_map<
 		not_null<PeerData*>,
 		std::unique_ptr<Ui::VideoUserpic>> _videoUserpics;
+	base::flat_map<Key, RowCache> _rowCaches;
 
 	base::flat_map<FilterId, int> _chatsFilterScrollStates;
 
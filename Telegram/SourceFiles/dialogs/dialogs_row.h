@@ -68,6 +68,9 @@ public:
 		int y,
 		int outerWidth,
 		const QColor *colorOverride = nullptr) const;
+	[[nodiscard]] bool hasRipple() const {
+		return (_ripple != nullptr);
+	}
 
 	[[nodiscard]] Ui::PeerUserpicView &userpicView() const {
 		return _userpic;
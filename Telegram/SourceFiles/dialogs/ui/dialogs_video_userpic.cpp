@@ -20,32 +20,125 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Dialogs::Ui {
 
-VideoUserpic::VideoUserpic(not_null<PeerData*> peer, Fn<void()> repaint)
-: _peer(peer)
-, _repaint(std::move(repaint)) {
+class VideoUserpic::Shared final {
+public:
+	explicit Shared(not_null<PeerData*> peer);
+
+	void add(not_null<VideoUserpic*> user);
+	void remove(not_null<VideoUserpic*> user);
+	[[nodiscard]] int surfaces() const;
+
+	[[nodiscard]] QImage frame(
+		not_null<VideoUserpic*> user,
+		int size,
+		bool paused);
+
+private:
+	struct Scaled {
+		QImage image;
+		int index = -1;
+	};
+	struct Surface {
+		int size = 0;
+		bool paused = false;
+		QImage frozen;
+	};
+
+	void validate();
+	void clipCallback(Media::Clip::Notification notification);
+	void repaint();
+	bool startReady();
+	[[nodiscard]] int largestSize() const;
+	[[nodiscard]] bool anyPlaying() const;
+	[[nodiscard]] Media::Clip::FrameRequest request(int size) const;
+
+	const not_null<PeerData*> _peer;
+
+	// Surfaces with the last size and paused state they painted with.
+	base::flat_map<not_null<VideoUserpic*>, Surface> _users;
+
+	Media::Clip::ReaderPointer _video;
+	std::shared_ptr<Data::PhotoMedia> _videoPhotoMedia;
+	PhotoId _videoPhotoId = 0;
+	base::flat_map<int, Scaled> _scaled;
+
+};
+
+VideoUserpic::Shared::Shared(not_null<PeerData*> peer) : _peer(peer) {
 }
 
-VideoUserpic::~VideoUserpic() = default;
+void VideoUserpic::Shared::add(not_null<VideoUserpic*> user) {
+	_users.emplace(user, Surface());
+}
 
-int VideoUserpic::frameIndex() const {
-	return -1;
+void VideoUserpic::Shared::remove(not_null<VideoUserpic*> user) {
+	_users.remove(user);
 }
 
-void VideoUserpic::paintLeft(
-		Painter &p,
-		Ui::PeerUserpicView &view,
-		int x,
-		int y,
-		int w,
+int VideoUserpic::Shared::surfaces() const {
+	return int(_users.size());
+}
+
+QImage VideoUserpic::Shared::frame(
+		not_null<VideoUserpic*> user,
 		int size,
 		bool paused) {
-	_lastSize = size;
+	auto &surface = _users[user];
+	surface.size = size;
+	surface.paused = paused;
+	if (!paused) {
+		surface.frozen = QImage();
+	}
+	validate();
+	if (!_video || !_video->ready()) {
+		return QImage();
+	}
+	startReady();
+
+	// A paused surface keeps the frame it showed and doesn't touch
+	// the reader, so it won't pause the video for the other surfaces.
+	const auto factor = style::DevicePixelRatio();
+	if (paused && surface.frozen.size() == QSize(size, size) * factor) {
+		return surface.frozen;
+	}
+	const auto now = anyPlaying() ? crl::now() : crl::time(0);
+	const auto largest = largestSize();
+	if (size == largest) {
+		auto result = _video->current(request(size), now);
+		if (paused) {
+			surface.frozen = result;
+		}
+		return result;
+	}
+
+	// Smaller surfaces downscale the frame prepared for the largest one.
+	const auto info = _video->frameInfo(request(largest), now);
+	_video->moveToNextFrame();
+	auto &scaled = _scaled[size];
+	if (scaled.index != info.index || scaled.image.isNull()) {
+		scaled.image = info.image.scaled(
+			QSize(size, size) * factor,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		scaled.image.setDevicePixelRatio(factor);
+		scaled.index = info.index;
+	}
+	if (paused) {
+		surface.frozen = scaled.image;
+	}
+	return scaled.image;
+}
 
+void VideoUserpic::Shared::validate() {
 	const auto photoId = _peer->userpicPhotoId();
 	if (_videoPhotoId != photoId) {
 		_videoPhotoId = photoId;
 		_video = nullptr;
 		_videoPhotoMedia = nullptr;
+		_scaled.clear();
+		for (auto &[user, surface] : _users) {
+			surface.frozen = QImage();
+		}
 		const auto photo = _peer->owner().photo(photoId);
 		if (photo->isNull()) {
 			_peer->updateFullForced();
@@ -56,47 +149,49 @@ void VideoUserpic::paintLeft(
 				_peer->userpicPhotoOrigin());
 		}
 	}
-	if (!_video) {
-		if (!_videoPhotoMedia) {
-			const auto photo = _peer->owner().photo(photoId);
-			if (!photo->isNull()) {
-				_videoPhotoMedia = photo->createMediaView();
-				_videoPhotoMedia->videoWanted(
-					Data::PhotoSize::Small,
-					_peer->userpicPhotoOrigin());
-			}
-		}
-		if (_videoPhotoMedia) {
-			auto small = _videoPhotoMedia->videoContent(
-				Data::PhotoSize::Small);
-			auto bytes = small.isEmpty()
-				? _videoPhotoMedia->videoContent(Data::PhotoSize::Large)
-				: small;
-			if (!bytes.isEmpty()) {
-				auto callback = [=](Media::Clip::Notification notification) {
-					clipCallback(notification);
-				};
-				_video = Media::Clip::MakeReader(
-					Core::FileLocation(),
-					std::move(bytes),
-					std::move(callback));
-			}
+	if (_video) {
+		return;
+	} else if (!_videoPhotoMedia) {
+		const auto photo = _peer->owner().photo(photoId);
+		if (!photo->isNull()) {
+			_videoPhotoMedia = photo->createMediaView();
+			_videoPhotoMedia->videoWanted(
+				Data::PhotoSize::Small,
+				_peer->userpicPhotoOrigin());
 		}
 	}
-	if (rtl()) {
-		x = w - x - size;
+	if (_videoPhotoMedia) {
+		auto small = _videoPhotoMedia->videoContent(Data::PhotoSize::Small);
+		auto bytes = small.isEmpty()
+			? _videoPhotoMedia->videoContent(Data::PhotoSize::Large)
+			: small;
+		if (!bytes.isEmpty()) {
+			auto callback = [=](Media::Clip::Notification notification) {
+				clipCallback(notification);
+			};
+			_video = Media::Clip::MakeReader(
+				Core::FileLocation(),
+				std::move(bytes),
+				std::move(callback));
+		}
 	}
-	if (_video && _video->ready()) {
-		startReady();
+}
 
-		const auto now = paused ? crl::time(0) : crl::now();
-		p.drawImage(x, y, _video->current(request(size), now));
-	} else {
-		_peer->paintUserpicLeft(p, view, x, y, w, size);
+int VideoUserpic::Shared::largestSize() const {
+	auto result = 0;
+	for (const auto &[user, surface] : _users) {
+		accumulate_max(result, surface.size);
 	}
+	return result;
 }
 
-Media::Clip::FrameRequest VideoUserpic::request(int size) const {
+bool VideoUserpic::Shared::anyPlaying() const {
+	return ranges::any_of(_users, [](const auto &pair) {
+		return !pair.second.paused;
+	});
+}
+
+Media::Clip::FrameRequest VideoUserpic::Shared::request(int size) const {
 	return {
 		.frame = { size, size },
 		.outer = { size, size },
@@ -105,18 +200,25 @@ Media::Clip::FrameRequest VideoUserpic::request(int size) const {
 	};
 }
 
-bool VideoUserpic::startReady(int size) {
+bool VideoUserpic::Shared::startReady() {
 	if (!_video->ready() || _video->started()) {
 		return false;
-	} else if (!_lastSize) {
-		_lastSize = size ? size : _video->width();
 	}
-	_video->start(request(_lastSize));
-	_repaint();
+	const auto size = largestSize();
+	_video->start(request(size ? size : _video->width()));
+	repaint();
 	return true;
 }
 
-void VideoUserpic::clipCallback(Media::Clip::Notification notification) {
+void VideoUserpic::Shared::repaint() {
+	const auto users = _users;
+	for (const auto &[user, surface] : users) {
+		user->_repaint();
+	}
+}
+
+void VideoUserpic::Shared::clipCallback(
+		Media::Clip::Notification notification) {
 	using namespace Media::Clip;
 
 	switch (notification) {
@@ -124,11 +226,77 @@ void VideoUserpic::clipCallback(Media::Clip::Notification notification) {
 		if (_video->state() == State::Error) {
 			_video.setBad();
 		} else if (startReady()) {
-			_repaint();
+			repaint();
 		}
 	} break;
 
-	case Notification::Repaint: _repaint(); break;
+	case Notification::Repaint: repaint(); break;
+	}
+}
+
+VideoUserpic::VideoUserpic(not_null<PeerData*> peer, Fn<void()> repaint)
+: _peer(peer)
+, _repaint(std::move(repaint))
+, _shared(LookupShared(peer)) {
+	_shared->add(this);
+}
+
+VideoUserpic::~VideoUserpic() {
+	_shared->remove(this);
+}
+
+std::shared_ptr<VideoUserpic::Shared> VideoUserpic::LookupShared(
+		not_null<PeerData*> peer) {
+	static auto all = base::flat_map<
+		not_null<PeerData*>,
+		std::weak_ptr<Shared>>();
+
+	auto result = std::shared_ptr<Shared>();
+	auto decoders = 0;
+	auto surfaces = 1;
+	for (auto i = begin(all); i != end(all);) {
+		if (const auto strong = i->second.lock()) {
+			if (i->first == peer) {
+				result = strong;
+			} else {
+				++decoders;
+			}
+			surfaces += strong->surfaces();
+			++i;
+		} else {
+			i = all.erase(i);
+		}
+	}
+	if (!result) {
+		result = std::make_shared<Shared>(peer);
+		all.emplace_or_assign(peer, result);
+	}
+	DEBUG_LOG(("Video Userpic: %1 decoders for %2 surfaces."
+		).arg(decoders + 1
+		).arg(surfaces));
+	return result;
+}
+
+int VideoUserpic::frameIndex() const {
+	return -1;
+}
+
+void VideoUserpic::paintLeft(
+		Painter &p,
+		Ui::PeerUserpicView &view,
+		int x,
+		int y,
+		int w,
+		int size,
+		bool paused) {
+	if (rtl()) {
+		x = w - x - size;
+	}
+	const auto frame = _shared->frame(this, size, paused);
+	if (!frame.isNull()) {
+		p.drawImage(x, y, frame);
+	} else {
+		_peer->paintUserpicLeft(p, view, x, y, w, size);
 	}
 }
 
@@ -46,17 +46,16 @@ public:
 		bool paused);
 
 private:
-	void clipCallback(Media::Clip::Notification notification);
-	[[nodiscard]] Media::Clip::FrameRequest request(int size) const;
-	bool startReady(int size = 0);
+	// One decoder for all the surfaces showing the same peer userpic.
+	class Shared;
+
+	[[nodiscard]] static std::shared_ptr<Shared> LookupShared(
+		not_null<PeerData*> peer);
 
 	const not_null<PeerData*> _peer;
 	const Fn<void()> _repaint;
 
-	Media::Clip::ReaderPointer _video;
-	int _lastSize = 0;
-	std::shared_ptr<Data::PhotoMedia> _videoPhotoMedia;
-	PhotoId _videoPhotoId = 0;
+	const std::shared_ptr<Shared> _shared;
 
 };
 
@@ -19,6 +19,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #ifdef LIB_FFMPEG_USE_QT_PRIVATE_API
 #include <private/qdrawhelper_p.h>
+#elif defined __SSE2__ || defined _M_X64 \
+	|| (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define LIB_FFMPEG_USE_SSE2
+#include <emmintrin.h>
+#elif defined __aarch64__ || defined _M_ARM64
+#define LIB_FFMPEG_USE_NEON
+#include <arm_neon.h>
 #endif // LIB_FFMPEG_USE_QT_PRIVATE_API
 
 extern "C" {
@@ -36,6 +43,8 @@ constexpr auto kMaxScaleByAspectRatio = 16;
 constexpr auto kAvioBlockSize = 4096;
 constexpr auto kTimeUnknown = std::numeric_limits<crl::time>::min();
 constexpr auto kDurationMax = crl::time(std::numeric_limits<int>::max());
+constexpr auto kSurfaceAreaPerDecodeThread = 1280 * 720;
+constexpr auto kMaxSurfaceDecodeThreads = 2;
 
 using GetFormatMethod = enum AVPixelFormat(*)(
 	struct AVCodecContext *s,
@@ -63,14 +72,149 @@ void AlignedImageBufferCleanupHandler(void* data) {
 		&& !(image.bytesPerLine() % kAlignImageBy);
 }
 
+#if defined LIB_FFMPEG_USE_SSE2
+
+// Same rounding as in qPremultiply(), eight 16 bit channels at once.
+[[nodiscard]] inline __m128i PremultiplyChannels(
+		__m128i channels,
+		__m128i alphaLanes) {
+	const auto half = _mm_set1_epi16(0x80);
+
+	// Alpha lanes are multiplied by 255, which leaves them as they were.
+	const auto alpha = _mm_or_si128(
+		_mm_shufflehi_epi16(
+			_mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)),
+			_MM_SHUFFLE(3, 3, 3, 3)),
+		alphaLanes);
+	const auto multiplied = _mm_mullo_epi16(channels, alpha);
+	return _mm_srli_epi16(
+		_mm_add_epi16(
+			_mm_add_epi16(multiplied, _mm_srli_epi16(multiplied, 8)),
+			half),
+		8);
+}
+
+void PremultiplyPixels(uint *dst, const uint *src, int count) {
+	const auto zero = _mm_setzero_si128();
+	const auto alphaLanes = _mm_set_epi16(0xFF, 0, 0, 0, 0xFF, 0, 0, 0);
+	const auto opaque = _mm_set1_epi32(int(0xFF000000));
+	auto i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const auto pixels = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(src + i));
+		const auto alpha = _mm_and_si128(pixels, opaque);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xFFFF) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pixels);
+			continue;
+		}
+		const auto low = PremultiplyChannels(
+			_mm_unpacklo_epi8(pixels, zero),
+			alphaLanes);
+		const auto high = PremultiplyChannels(
+			_mm_unpackhi_epi8(pixels, zero),
+			alphaLanes);
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(dst + i),
+			_mm_packus_epi16(low, high));
+	}
+	for (; i != count; ++i) {
+		dst[i] = qPremultiply(src[i]);
+	}
+}
+
+void UnPremultiplyPixels(uint *dst, const uint *src, int count) {
+	const auto zero = _mm_setzero_si128();
+	const auto opaque = _mm_set1_epi32(int(0xFF000000));
+	auto i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const auto pixels = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(src + i));
+		const auto alpha = _mm_and_si128(pixels, opaque);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xFFFF) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pixels);
+		} else if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero))
+			== 0xFFFF) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), zero);
+		} else {
+			for (auto j = i; j != i + 4; ++j) {
+				dst[j] = qUnpremultiply(src[j]);
+			}
+		}
+	}
+	for (; i != count; ++i) {
+		dst[i] = qUnpremultiply(src[i]);
+	}
+}
+
+#elif defined LIB_FFMPEG_USE_NEON
+
+// Same rounding as in qPremultiply(), eight channels at once.
+[[nodiscard]] inline uint8x8_t PremultiplyChannel(
+		uint8x8_t channel,
+		uint8x8_t alpha) {
+	const auto multiplied = vmull_u8(channel, alpha);
+	return vrshrn_n_u16(vsraq_n_u16(multiplied, multiplied, 8), 8);
+}
+
+void PremultiplyPixels(uint *dst, const uint *src, int count) {
+	auto i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto pixels = vld4_u8(reinterpret_cast<const uint8_t*>(src + i));
+		const auto alpha = pixels.val[3];
+		if (vminv_u8(alpha) != 0xFF) {
+			pixels.val[0] = PremultiplyChannel(pixels.val[0], alpha);
+			pixels.val[1] = PremultiplyChannel(pixels.val[1], alpha);
+			pixels.val[2] = PremultiplyChannel(pixels.val[2], alpha);
+		}
+		vst4_u8(reinterpret_cast<uint8_t*>(dst + i), pixels);
+	}
+	for (; i != count; ++i) {
+		dst[i] = qPremultiply(src[i]);
+	}
+}
+
+void UnPremultiplyPixels(uint *dst, const uint *src, int count) {
+	auto i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const auto pixels = vld1q_u32(src + i);
+		const auto alpha = vshrq_n_u32(pixels, 24);
+		if (vminvq_u32(alpha) == 0xFF) {
+			vst1q_u32(dst + i, pixels);
+		} else if (vmaxvq_u32(alpha) == 0) {
+			vst1q_u32(dst + i, vdupq_n_u32(0));
+		} else {
+			for (auto j = i; j != i + 4; ++j) {
+				dst[j] = qUnpremultiply(src[j]);
+			}
+		}
+	}
+	for (; i != count; ++i) {
+		dst[i] = qUnpremultiply(src[i]);
+	}
+}
+
+#elif !defined LIB_FFMPEG_USE_QT_PRIVATE_API
+
+void PremultiplyPixels(uint *dst, const uint *src, int count) {
+	for (auto i = 0; i != count; ++i) {
+		dst[i] = qPremultiply(src[i]);
+	}
+}
+
+void UnPremultiplyPixels(uint *dst, const uint *src, int count) {
+	for (auto i = 0; i != count; ++i) {
+		dst[i] = qUnpremultiply(src[i]);
+	}
+}
+
+#endif // LIB_FFMPEG_USE_SSE2 || LIB_FFMPEG_USE_NEON
+
 void UnPremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 	[[maybe_unused]] const auto udst = reinterpret_cast<uint*>(dst);
 	const auto usrc = reinterpret_cast<const uint*>(src);
 
 #ifndef LIB_FFMPEG_USE_QT_PRIVATE_API
-	for (auto i = 0; i != intsCount; ++i) {
-		udst[i] = qUnpremultiply(usrc[i]);
-	}
+	UnPremultiplyPixels(udst, usrc, intsCount);
 #else // !LIB_FFMPEG_USE_QT_PRIVATE_API
 	static const auto layout = &qPixelLayouts[QImage::Format_ARGB32];
 	layout->storeFromARGB32PM(dst, usrc, 0, intsCount, nullptr, nullptr);
@@ -82,9 +226,7 @@ void PremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 	[[maybe_unused]] const auto usrc = reinterpret_cast<const uint*>(src);
 
 #ifndef LIB_FFMPEG_USE_QT_PRIVATE_API
-	for (auto i = 0; i != intsCount; ++i) {
-		udst[i] = qPremultiply(usrc[i]);
-	}
+	PremultiplyPixels(udst, usrc, intsCount);
 #else // !LIB_FFMPEG_USE_QT_PRIVATE_API
 	static const auto layout = &qPixelLayouts[QImage::Format_ARGB32];
 	layout->fetchToARGB32PM(udst, src, 0, intsCount, nullptr, nullptr);
@@ -148,6 +290,56 @@ void PremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 	return true;
 }
 
+void ApplySurfaceLimit(
+		not_null<AVCodecContext*> context,
+		not_null<const AVCodec*> codec,
+		QSize surface) {
+	const auto width = context->width;
+	const auto height = context->height;
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
+	// Each lowres step halves the output, keep it not less than surface.
+	auto lowres = 0;
+	while (lowres < codec->max_lowres
+		&& (width >> (lowres + 1)) >= surface.width()
+		&& (height >> (lowres + 1)) >= surface.height()) {
+		++lowres;
+	}
+	context->lowres = lowres;
+
+	// Deblocking artifacts are hidden by the following downscale anyway.
+	const auto scale = std::min(
+		(width >> lowres) / surface.width(),
+		(height >> lowres) / surface.height());
+	if (scale >= 4) {
+		context->skip_loop_filter = AVDISCARD_ALL;
+	} else if (scale >= 2) {
+		context->skip_loop_filter = AVDISCARD_NONREF;
+	}
+
+	// Many small videos are played at once, bubble-sized ones get
+	// a single thread. Frame threading adds a frame of latency and
+	// a frame buffer per thread, so only slice threading is allowed.
+	const auto area = surface.width() * surface.height();
+	context->thread_count = std::clamp(
+		area / kSurfaceAreaPerDecodeThread,
+		1,
+		kMaxSurfaceDecodeThreads);
+	context->thread_type = FF_THREAD_SLICE;
+
+	DEBUG_LOG(("Video Info: Decoding %1x%2 with lowres %3, "
+		"loop filter skip %4 and %5 threads for %6x%7 surface."
+		).arg(width
+		).arg(height
+		).arg(lowres
+		).arg(int(context->skip_loop_filter)
+		).arg(context->thread_count
+		).arg(surface.width()
+		).arg(surface.height()));
+}
+
 [[nodiscard]] enum AVPixelFormat GetHwFormat(
 		AVCodecContext *context,
 		const enum AVPixelFormat *formats) {
@@ -403,6 +595,9 @@ CodecPointer MakeCodecPointer(CodecDescriptor descriptor) {
 		DEBUG_LOG(("Video Info: Using software \"%2\" decoder."
 			).arg(codec->name));
 	}
+	if (!descriptor.surface.isEmpty()) {
+		ApplySurfaceLimit(context, codec, descriptor.surface);
+	}
 
 	if ((error = avcodec_open2(context, codec, nullptr))) {
 		LogError(u"avcodec_open2"_q, error);
@@ -159,6 +159,10 @@ using CodecPointer = std::unique_ptr<AVCodecContext, CodecDeleter>;
 struct CodecDescriptor {
 	not_null<AVStream*> stream;
 	bool hwAllowed = false;
+
+	// Largest size the frames will be shown at, empty for the full size.
+	// Allows the decoder to reduce the output and skip some filtering.
+	QSize surface;
 };
 [[nodiscard]] CodecPointer MakeCodecPointer(CodecDescriptor descriptor);
 
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "history/history_inner_widget.h"
 
+#include "base/options.h"
 #include "chat_helpers/stickers_emoji_pack.h"
 #include "core/file_utilities.h"
 #include "core/click_handler_types.h"
@@ -104,6 +105,14 @@ namespace {
 constexpr auto kScrollDateHideTimeout = 1000;
 constexpr auto kUnloadHeavyPartsPages = 2;
 constexpr auto kClearUserpicsAfter = 50;
+constexpr auto kPaintedAreaLogEach = crl::time(1000);
+
+base::options::toggle OptionChatRepaintOverlay({
+	.id = kOptionChatRepaintOverlay,
+	.name = "Show repainted chat areas",
+	.description = "Tint the repainted parts of the chat history"
+		" and log the repainted area per second.",
+});
 
 // Helper binary search for an item in a list that is not completely
 // above the given top of the visible area or below the given bottom of the visible area
@@ -127,6 +136,8 @@ int BinarySearchBlocksOrItems(const T &list, int edge) {
 
 } // namespace
 
+const char kOptionChatRepaintOverlay[] = "chat-repaint-overlay";
+
 // flick scroll taken from http://qt-project.org/doc/qt-4.8/demos-embedded-anomaly-src-flickcharm-cpp.html
 
 HistoryMainElementDelegateMixin::HistoryMainElementDelegateMixin() = default;
@@ -390,9 +401,13 @@ HistoryInner::HistoryInner(
 	}) | rpl::start_with_next([this] {
 		mouseActionCancel();
 	}, lifetime());
-	session().data().viewRepaintRequest(
-	) | rpl::start_with_next([this](not_null<const Element*> view) {
-		repaintItem(view);
+	session().data().viewRepaintRectRequest(
+	) | rpl::start_with_next([this](const Data::ViewRepaintRequest &request) {
+		if (request.rect.isNull()) {
+			repaintItem(request.view);
+		} else {
+			repaintItemRect(request.view, request.rect);
+		}
 	}, lifetime());
 	session().data().viewLayoutChanged(
 	) | rpl::filter([=](not_null<const Element*> view) {
@@ -650,6 +665,18 @@ void HistoryInner::repaintItem(const Element *view) {
 	}
 }
 
+void HistoryInner::repaintItemRect(
+		not_null<const Element*> view,
+		QRect rect) {
+	if (_widget->skipItemRepaint()) {
+		return;
+	}
+	const auto top = itemTop(view);
+	if (top >= 0) {
+		update(rect.translated(0, top));
+	}
+}
+
 template <bool TopToBottom, typename Method>
 void HistoryInner::enumerateItemsInHistory(History *history, int historytop, Method method) {
 	// No displayed messages in this history.
@@ -948,6 +975,49 @@ void HistoryInner::startEffectOnRead(not_null<HistoryItem*> item) {
 	}
 }
 
+void HistoryInner::countPaintedArea(const QRegion &region) {
+	if (!OptionChatRepaintOverlay.value()) {
+		return;
+	}
+	for (const auto &rect : region) {
+		_paintedArea += int64(rect.width()) * rect.height();
+	}
+	++_paintedCount;
+
+	const auto now = crl::now();
+	const auto duration = now - _paintedAreaStarted;
+	if (!_paintedAreaStarted) {
+		_paintedAreaStarted = now;
+	} else if (duration >= kPaintedAreaLogEach) {
+		const auto perSecond = 1000. / duration;
+		const auto screen = int64(width())
+			* std::max(_visibleAreaBottom - _visibleAreaTop, 1);
+		LOG(("History Paint: %1 paints, %2 screens repainted per second."
+			).arg(_paintedCount * perSecond, 0, 'f', 1
+			).arg(_paintedArea * perSecond / screen, 0, 'f', 2));
+		_paintedArea = 0;
+		_paintedCount = 0;
+		_paintedAreaStarted = now;
+	}
+}
+
+void HistoryInner::paintRepaintOverlay(
+		QPainter &p,
+		const QRegion &region) {
+	static auto index = 0;
+	static const auto colors = std::array{
+		QColor(255, 0, 0, 32),
+		QColor(0, 255, 0, 32),
+		QColor(0, 0, 255, 32),
+	};
+	p.resetTransform();
+	p.setOpacity(1.);
+	const auto &color = colors[index++ % colors.size()];
+	for (const auto &rect : region) {
+		p.fillRect(rect, color);
+	}
+}
+
 void HistoryInner::paintEvent(QPaintEvent *e) {
 	if (_controller->contentOverlapped(this, e)
 		|| hasPendingResizedItems()) {
@@ -960,6 +1030,19 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 	Painter p(this);
 	auto clip = e->rect();
 
+	// Several distant parts may be requested, skip views between them.
+	const auto &region = e->region();
+	const auto partial = (region.rectCount() > 1);
+	const auto skipDraw = [&](int top, int height) {
+		return partial && !region.intersects(QRect(0, top, width(), height));
+	};
+	countPaintedArea(region);
+	const auto overlay = gsl::finally([&] {
+		if (OptionChatRepaintOverlay.value()) {
+			paintRepaintOverlay(p, region);
+		}
+	});
+
 	auto context = preparePaintContext(clip);
 	context.gestureHorizontal = _gestureHorizontal;
 	context.highlightPathCache = &_highlightPathCache;
@@ -1098,7 +1181,9 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 				selfromy - mtop,
 				seltoy - mtop);
 			context.highlight = _widget->itemHighlight(view->data());
-			view->draw(p, context);
+			if (!skipDraw(top, height)) {
+				view->draw(p, context);
+			}
 			processPainted(view, top, height);
 
 			top += height;
@@ -1144,7 +1229,9 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 					selfromy - htop,
 					seltoy - htop);
 				context.highlight = _widget->itemHighlight(item);
-				view->draw(p, context);
+				if (!skipDraw(top, height)) {
+					view->draw(p, context);
+				}
 				processPainted(view, top, height);
 			}
 			top += height;
@@ -66,6 +66,8 @@ using namespace ::Ui;
 class VideoUserpic;
 } // namespace Dialogs::Ui
 
+extern const char kOptionChatRepaintOverlay[];
+
 class HistoryInner;
 class HistoryMainElementDelegate;
 class HistoryMainElementDelegateMixin {
@@ -127,6 +129,7 @@ public:
 
 	void repaintItem(const HistoryItem *item);
 	void repaintItem(const Element *view);
+	void repaintItemRect(not_null<const Element*> view, QRect rect);
 
 	[[nodiscard]] bool canCopySelected() const;
 	[[nodiscard]] bool canDeleteSelected() const;
@@ -244,6 +247,9 @@ private:
 	void onTouchSelect();
 	void onTouchScrollTimer();
 
+	void countPaintedArea(const QRegion &region);
+	void paintRepaintOverlay(QPainter &p, const QRegion &region);
+
 	[[nodiscard]] static int SelectionViewOffset(
 		not_null<const HistoryInner*> inner,
 		not_null<const Element*> view);
@@ -489,6 +495,10 @@ private:
 
 	std::unique_ptr<HistoryView::Reactions::Manager> _reactionsManager;
 	rpl::variable<HistoryItem*> _reactionsItem;
+
+	int64 _paintedArea = 0;
+	int _paintedCount = 0;
+	crl::time _paintedAreaStarted = 0;
 	HistoryItem *_pinnedItem = nullptr;
 
 	MouseAction _mouseAction = MouseAction::None;
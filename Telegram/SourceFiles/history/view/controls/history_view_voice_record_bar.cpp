@@ -30,6 +30,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/player/media_player_instance.h"
 #include "media/streaming/media_streaming_instance.h"
 #include "media/streaming/media_streaming_round_preview.h"
+#include "storage/file_upload.h"
 #include "storage/storage_account.h"
 #include "ui/controls/round_video_recorder.h"
 #include "ui/controls/send_button.h"
@@ -1822,6 +1823,9 @@ void VoiceRecordBar::startRecording() {
 				});
 			}
 		} else {
+			if (!_videoRecorder) {
+				_show->session().uploader().startStreamed();
+			}
 			instance()->start(_videoRecorder
 				? _videoRecorder->audioChunkProcessor()
 				: nullptr);
@@ -1832,6 +1836,12 @@ void VoiceRecordBar::startRecording() {
 		}, [=] {
 			stop(false);
 		}, _recordingLifetime);
+		if (!_videoRecorder) {
+			instance()->encoded(
+			) | rpl::start_with_next([=](const QByteArray &bytes) {
+				_show->session().uploader().feedStreamed(bytes);
+			}, _recordingLifetime);
+		}
 		if (_videoRecorder) {
 			_videoRecorder->updated(
 			) | rpl::start_with_next_error([=](const Update &update) {
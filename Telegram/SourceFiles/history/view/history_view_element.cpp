@@ -711,6 +711,10 @@ void Element::repaint() const {
 	history()->owner().requestViewRepaint(this);
 }
 
+void Element::repaint(QRect rect) const {
+	history()->owner().requestViewRepaint(this, rect);
+}
+
 void Element::paintHighlight(
 		Painter &p,
 		const PaintContext &context,
@@ -556,6 +556,7 @@ public:
 	void clearCustomEmojiRepaint() const;
 	void hideSpoilers();
 	void repaint() const;
+	void repaint(QRect rect) const;
 
 	[[nodiscard]] ClickHandlerPtr fromPhotoLink() const {
 		return fromLink();
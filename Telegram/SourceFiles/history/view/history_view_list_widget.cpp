@@ -414,10 +414,15 @@ ListWidget::ListWidget(
 	setAttribute(Qt::WA_AcceptTouchEvents);
 	setMouseTracking(true);
 	_scrollDateHideTimer.setCallback([this] { scrollDateHideByTimer(); });
-	_session->data().viewRepaintRequest(
-	) | rpl::start_with_next([this](auto view) {
-		if (view->delegate() == this) {
+	_session->data().viewRepaintRectRequest(
+	) | rpl::start_with_next([this](const Data::ViewRepaintRequest &request) {
+		const auto view = request.view;
+		if (view->delegate() != this) {
+			return;
+		} else if (request.rect.isNull()) {
 			repaintItem(view);
+		} else {
+			update(request.rect.translated(0, itemTop(view)));
 		}
 	}, lifetime());
 	_session->data().viewResizeRequest(
@@ -2257,6 +2262,13 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 
 	auto clip = e->rect();
 
+	// Several distant parts may be requested, skip views between them.
+	const auto &region = e->region();
+	const auto partial = (region.rectCount() > 1);
+	const auto skipDraw = [&](int top, int height) {
+		return partial && !region.intersects(QRect(0, top, width(), height));
+	};
+
 	auto from = std::lower_bound(begin(_items), end(_items), clip.top(), [this](auto &elem, int top) {
 		return this->itemTop(elem) + elem->height() <= top;
 	});
@@ -2292,7 +2304,9 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 			context.outbg = view->hasOutLayout();
 			context.selection = itemRenderSelection(view);
 			context.highlight = _highlighter.state(item);
-			view->draw(p, context);
+			if (!skipDraw(top, height)) {
+				view->draw(p, context);
+			}
 		}
 		if (_translateTracker) {
 			_translateTracker->add(view);
@@ -1310,6 +1310,7 @@ void Message::draw(Painter &p, const PaintContext &context) const {
 				&& context.highlightPathCache->isEmpty();
 			auto mediaPosition = QPoint(inner.left(), top);
 			p.translate(mediaPosition);
+			media->setPaintedPosition(mediaPosition);
 			media->draw(p, context.translated(
 				-mediaPosition
 			).withSelection(mediaSelection));
@@ -1431,6 +1432,7 @@ void Message::draw(Painter &p, const PaintContext &context) const {
 		}
 	} else if (media && media->isDisplayed()) {
 		p.translate(g.topLeft());
+		media->setPaintedPosition(g.topLeft());
 		media->draw(p, context.translated(
 			-g.topLeft()
 		).withSelection(skipTextSelection(context.selection)));
@@ -10,7 +10,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/random.h"
 #include "lang/lang_keys.h"
 #include "lottie/lottie_icon.h"
-#include "storage/localstorage.h"
 #include "main/main_session.h"
 #include "media/player/media_player_float.h" // Media::Player::RoundPainter.
 #include "media/audio/media_audio.h"
@@ -35,6 +34,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_document_media.h"
 #include "data/data_document_resolver.h"
 #include "data/data_file_click_handler.h"
+#include "data/data_waveform_counter.h"
 #include "api/api_transcribes.h"
 #include "apiwrap.h"
 #include "styles/style_chat.h"
@@ -838,10 +838,12 @@ void Document::draw(
 			const auto voiceData = _data->isVideoMessage()
 				? _data->round()
 				: _data->voice();
-			if (voiceData && voiceData->waveform.isEmpty()) {
-				if (loaded) {
-					Local::countVoiceWaveform(_dataMedia.get());
-				}
+			if (voiceData
+				&& loaded
+				&& (voiceData->waveform.isEmpty()
+					|| voiceData->waveform[0] == Data::kWaveformCounting)) {
+				// Counting ones are requested again to go first.
+				_data->owner().waveformCounter().request(_data);
 			}
 		}
 
@@ -239,12 +239,16 @@ QSize Gif::sizeForAspectRatio() const {
 	return { 1, 1 };
 }
 
-QSize Gif::countThumbSize(int &inOutWidthMax) const {
-	const auto maxSize = _data->isVideoFile()
+int Gif::maxThumbSize() const {
+	return _data->isVideoFile()
 		? st::maxMediaSize
 		: _data->isVideoMessage()
 		? st::maxVideoMessageSize
 		: st::maxGifSize;
+}
+
+QSize Gif::countThumbSize(int &inOutWidthMax) const {
+	const auto maxSize = maxThumbSize();
 	const auto size = style::ConvertScale(videoSize());
 	accumulate_min(inOutWidthMax, maxSize);
 	return DownscaledSize(size, { inOutWidthMax, maxSize });
@@ -1908,6 +1912,11 @@ void Gif::startStreamedPlayer() const {
 	options.mode = ::Media::Streaming::Mode::Video;
 	options.loop = true;
 	//}
+	if (!_data->isVideoMessage()) {
+		// Round video messages are shown close to their encoded size.
+		options.surface = QSize(maxThumbSize(), maxThumbSize())
+			* style::DevicePixelRatio();
+	}
 	_streamed->instance.play(options);
 }
 
@@ -1962,7 +1971,7 @@ void Gif::repaintStreamedContent() {
 		&& !activeRoundStreamed()) {
 		return;
 	}
-	repaint();
+	repaintContent();
 }
 
 void Gif::streamingReady(::Media::Streaming::Information &&info) {
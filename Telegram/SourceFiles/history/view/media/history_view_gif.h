@@ -124,6 +124,7 @@ private:
 	struct Streamed;
 
 	void validateVideoThumbnail() const;
+	[[nodiscard]] int maxThumbSize() const;
 	[[nodiscard]] QSize countThumbSize(int &inOutWidthMax) const;
 	[[nodiscard]] int adjustHeightForLessCrop(
 		QSize dimensions,
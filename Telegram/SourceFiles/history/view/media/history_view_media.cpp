@@ -533,6 +533,18 @@ void Media::repaint() const {
 	_parent->repaint();
 }
 
+void Media::repaintContent() const {
+	if (_paintedPosition) {
+		_parent->repaint(QRect(*_paintedPosition, currentSize()));
+	} else {
+		_parent->repaint();
+	}
+}
+
+void Media::setPaintedPosition(QPoint position) const {
+	_paintedPosition = position;
+}
+
 Ui::Text::String Media::createCaption(not_null<HistoryItem*> item) const {
 	if (item->emptyText()) {
 		return {};
@@ -129,6 +129,7 @@ public:
 		int top) const {
 	}
 	virtual void draw(Painter &p, const PaintContext &context) const = 0;
+	void setPaintedPosition(QPoint position) const;
 	[[nodiscard]] virtual PointState pointState(QPoint point) const;
 	[[nodiscard]] virtual TextState textState(
 		QPoint point,
@@ -406,10 +407,16 @@ protected:
 
 	void repaint() const;
 
+	// Repaints only the media area, if we know where it was painted.
+	void repaintContent() const;
+
 	const not_null<Element*> _parent;
 	MediaInBubbleState _inBubbleState = MediaInBubbleState::None;
 	Ui::BubbleRounding _bubbleRounding;
 
+	// Position in the parent view when it was last painted.
+	mutable std::optional<QPoint> _paintedPosition;
+
 };
 
 [[nodiscard]] Images::CornersMaskRef MediaRoundingMask(
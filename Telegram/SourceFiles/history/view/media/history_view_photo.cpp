@@ -286,7 +286,10 @@ void Photo::draw(Painter &p, const PaintContext &context) const {
 	}
 
 	ensureDataMediaCreated();
-	_dataMedia->automaticLoad(_realParent->fullId(), _parent->data());
+	_dataMedia->automaticLoad(
+		_realParent->fullId(),
+		_parent->data(),
+		decodeBox(currentSize()));
 	const auto st = context.st;
 	const auto sti = context.imageStyle();
 	const auto preview = _data->extendedMediaPreview();
@@ -632,6 +635,17 @@ QSize Photo::photoSize() const {
 	return QSize(_data->width(), _data->height());
 }
 
+QSize Photo::decodeBox(QSize outer) const {
+	// The large size is decoded only to the pixels covering the bubble.
+	const auto full = QSize(_data->width(), _data->height());
+	if (full.isEmpty() || outer.isEmpty()) {
+		return QSize();
+	}
+	return full.scaled(
+		outer * style::DevicePixelRatio(),
+		Qt::KeepAspectRatioByExpanding);
+}
+
 QRect Photo::enlargeRect() const {
 	const auto skip = st::historyPageEnlargeSkip;
 	const auto enlargeInner = st::historyPageEnlargeSize;
@@ -728,7 +742,10 @@ void Photo::drawGrouped(
 		not_null<uint64*> cacheKey,
 		not_null<QPixmap*> cache) const {
 	ensureDataMediaCreated();
-	_dataMedia->automaticLoad(_realParent->fullId(), _parent->data());
+	_dataMedia->automaticLoad(
+		_realParent->fullId(),
+		_parent->data(),
+		decodeBox(geometry.size()));
 
 	const auto st = context.st;
 	const auto sti = context.imageStyle();
@@ -1002,7 +1019,7 @@ void Photo::repaintStreamedContent() {
 	} else if (_parent->delegate()->elementAnimationsPaused()) {
 		return;
 	}
-	repaint();
+	repaintContent();
 }
 
 void Photo::streamingReady(::Media::Streaming::Information &&info) {
@@ -154,6 +154,7 @@ private:
 		QPoint photoPosition) const;
 
 	[[nodiscard]] QSize photoSize() const;
+	[[nodiscard]] QSize decodeBox(QSize outer) const;
 	[[nodiscard]] QRect enlargeRect() const;
 
 	void togglePollingStory(bool enabled) const;
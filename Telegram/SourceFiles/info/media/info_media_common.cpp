@@ -87,4 +87,108 @@ int MinItemHeight(Type type, int width) {
 	}
 	Unexpected("Type in MinItemHeight()");
 }
+
+void ListSectionHeights::assign(std::vector<int> heights) {
+	_heights = std::move(heights);
+	rebuild();
+}
+
+void ListSectionHeights::clear() {
+	_heights.clear();
+	_tree.clear();
+	_total = 0;
+}
+
+void ListSectionHeights::set(int index, int height) {
+	Expects(index >= 0 && index < size());
+
+	const auto delta = height - _heights[index];
+	if (!delta) {
+		return;
+	}
+	_heights[index] = height;
+	_total += delta;
+	const auto count = size();
+	for (auto i = index + 1; i <= count; i += (i & -i)) {
+		_tree[i] += delta;
+	}
+}
+
+void ListSectionHeights::erase(int index) {
+	Expects(index >= 0 && index < size());
+
+	_heights.erase(begin(_heights) + index);
+	rebuild();
+}
+
+int ListSectionHeights::size() const {
+	return int(_heights.size());
+}
+
+int ListSectionHeights::height(int index) const {
+	Expects(index >= 0 && index < size());
+
+	return _heights[index];
+}
+
+int ListSectionHeights::top(int index) const {
+	Expects(index >= 0 && index <= size());
+
+	auto result = 0;
+	for (auto i = index; i > 0; i -= (i & -i)) {
+		result += _tree[i];
+	}
+	return result;
+}
+
+int ListSectionHeights::total() const {
+	return _total;
+}
+
+int ListSectionHeights::findAfterTop(int top) const {
+	return std::min(countPrefixSize(top), size());
+}
+
+int ListSectionHeights::findAfterBottom(int bottom) const {
+	if (bottom <= 0) {
+		return 0;
+	}
+	return std::min(countPrefixSize(bottom - 1) + 1, size());
+}
+
+int ListSectionHeights::countPrefixSize(int value) const {
+	// Largest count of leading sections with the summary height <= value.
+	if (value < 0) {
+		return 0;
+	}
+	const auto count = size();
+	auto step = 1;
+	while ((step << 1) <= count) {
+		step <<= 1;
+	}
+	auto result = 0;
+	for (; step > 0; step >>= 1) {
+		const auto next = result + step;
+		if (next <= count && _tree[next] <= value) {
+			result = next;
+			value -= _tree[next];
+		}
+	}
+	return result;
+}
+
+void ListSectionHeights::rebuild() {
+	const auto count = size();
+	_tree.assign(count + 1, 0);
+	_total = 0;
+	for (auto i = 1; i <= count; ++i) {
+		_tree[i] += _heights[i - 1];
+		_total += _heights[i - 1];
+		const auto parent = i + (i & -i);
+		if (parent <= count) {
+			_tree[parent] += _tree[i];
+		}
+	}
+}
+
 } // namespace Info::Media
@@ -174,4 +174,35 @@ public:
 
 [[nodiscard]] int MinItemHeight(Type type, int width);
 
+// Cumulative section heights in a Fenwick tree, so that finding a section
+// by its vertical coordinate and updating a single section height after
+// its lazy layout both take O(log n) even with thousands of sections.
+class ListSectionHeights final {
+public:
+	void assign(std::vector<int> heights);
+	void clear();
+	void set(int index, int height);
+	void erase(int index);
+
+	[[nodiscard]] int size() const;
+	[[nodiscard]] int height(int index) const;
+	[[nodiscard]] int top(int index) const;
+	[[nodiscard]] int total() const;
+
+	// First index with (top(index) + height(index) > top) or size().
+	[[nodiscard]] int findAfterTop(int top) const;
+
+	// First index with (top(index) >= bottom) or size().
+	[[nodiscard]] int findAfterBottom(int bottom) const;
+
+private:
+	[[nodiscard]] int countPrefixSize(int value) const;
+	void rebuild();
+
+	std::vector<int> _heights;
+	std::vector<int> _tree;
+	int _total = 0;
+
+};
+
 } // namespace Info::Media
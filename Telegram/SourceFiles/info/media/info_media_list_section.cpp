@@ -341,15 +341,7 @@ void ListSection::resizeToWidth(int newWidth) {
 	case Type::Video:
 	case Type::PhotoVideo:
 	case Type::RoundFile: {
-		const auto skip = st::infoMediaSkip;
-		_itemsLeft = st::infoMediaLeft;
-		_itemsTop = st::infoMediaSkip;
-		_itemsInRow = (newWidth - _itemsLeft * 2 + skip)
-			/ (st::infoMediaMinGridSize + skip);
-		_itemWidth = ((newWidth - _itemsLeft * 2 + skip) / _itemsInRow)
-			- st::infoMediaSkip;
-		_itemsLeft = (newWidth - (_itemWidth + skip) * _itemsInRow + skip)
-			/ 2;
+		applyGridSizes(newWidth);
 		for (auto &item : _items) {
 			_itemHeight = item->resizeGetHeight(_itemWidth);
 		}
@@ -371,9 +363,83 @@ void ListSection::resizeToWidth(int newWidth) {
 	} break;
 	}
 
+	_layoutWidth = newWidth;
+	_pendingWidth = 0;
 	refreshHeight();
 }
 
+void ListSection::resizeToWidthLazy(int newWidth) {
+	if (_type == Type::GIF || _items.empty()) {
+		// Mosaic layout doesn't resize items, nothing to postpone here.
+		resizeToWidth(newWidth);
+		return;
+	} else if (newWidth == _layoutWidth) {
+		_pendingWidth = 0;
+		return;
+	}
+	const auto minWidth = st::infoMediaMinGridSize + st::infoMediaSkip * 2;
+	if (newWidth < minWidth) {
+		return;
+	}
+	_pendingWidth = newWidth;
+	_height = countEstimatedHeight(newWidth);
+}
+
+bool ListSection::layoutValid() const {
+	return !_pendingWidth;
+}
+
+void ListSection::validateLayout() {
+	if (_pendingWidth) {
+		resizeToWidth(_pendingWidth);
+	}
+}
+
+void ListSection::applyGridSizes(int newWidth) {
+	const auto skip = st::infoMediaSkip;
+	_itemsLeft = st::infoMediaLeft;
+	_itemsTop = st::infoMediaSkip;
+	_itemsInRow = (newWidth - _itemsLeft * 2 + skip)
+		/ (st::infoMediaMinGridSize + skip);
+	_itemWidth = ((newWidth - _itemsLeft * 2 + skip) / _itemsInRow)
+		- st::infoMediaSkip;
+	_itemsLeft = (newWidth - (_itemWidth + skip) * _itemsInRow + skip)
+		/ 2;
+}
+
+int ListSection::countEstimatedHeight(int newWidth) {
+	Expects(!_items.empty());
+
+	auto result = headerHeight();
+	switch (_type) {
+	case Type::Photo:
+	case Type::Video:
+	case Type::PhotoVideo:
+	case Type::RoundFile: {
+		// All grid items have the same height, so this one is exact.
+		applyGridSizes(newWidth);
+		_itemHeight = _items.front()->resizeGetHeight(_itemWidth);
+		const auto count = int(_items.size());
+		const auto rows = (count + _itemsInRow - 1) / _itemsInRow;
+		result += _itemsTop + rows * (_itemHeight + st::infoMediaSkip);
+	} break;
+
+	case Type::RoundVoiceFile:
+	case Type::File:
+	case Type::MusicFile:
+	case Type::Link:
+		for (const auto &item : _items) {
+			const auto height = item->height();
+			result += height ? height : item->minHeight();
+		}
+		break;
+
+	case Type::GIF:
+		Unexpected("Type in ListSection::countEstimatedHeight.");
+	}
+	return result;
+}
+
 int ListSection::recountHeight() {
 	auto result = headerHeight();
 
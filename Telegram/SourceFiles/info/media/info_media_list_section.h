@@ -29,6 +29,11 @@ public:
 	void resizeToWidth(int newWidth);
 	[[nodiscard]] int height() const;
 
+	// Only estimates the height, the items are laid out in validateLayout().
+	void resizeToWidthLazy(int newWidth);
+	[[nodiscard]] bool layoutValid() const;
+	void validateLayout();
+
 	[[nodiscard]] int bottom() const;
 
 	bool removeItem(not_null<const HistoryItem*> item);
@@ -51,6 +56,8 @@ public:
 
 private:
 	[[nodiscard]] int headerHeight() const;
+	void applyGridSizes(int newWidth);
+	[[nodiscard]] int countEstimatedHeight(int newWidth);
 	void appendItem(not_null<BaseLayout*> item);
 	void setHeader(not_null<BaseLayout*> item);
 	[[nodiscard]] bool belongsHere(not_null<BaseLayout*> item) const;
@@ -87,6 +94,8 @@ private:
 	mutable int _rowsCount = 0;
 	int _top = 0;
 	int _height = 0;
+	int _layoutWidth = 0;
+	int _pendingWidth = 0;
 
 	Mosaic::Layout::MosaicLayout<BaseLayout> _mosaic;
 
@@ -73,6 +73,7 @@ namespace Media {
 namespace {
 
 constexpr auto kMediaCountForSearch = 10;
+constexpr auto kLayoutMarginScreens = 1;
 
 } // namespace
 
@@ -299,6 +300,7 @@ void ListWidget::restart() {
 
 	_overLayout = nullptr;
 	_sections.clear();
+	_sectionHeights.clear();
 	_heavyLayouts.clear();
 
 	_provider->restart();
@@ -317,8 +319,12 @@ void ListWidget::itemRemoved(not_null<const HistoryItem*> item) {
 	auto sectionIt = findSectionByItem(item);
 	if (sectionIt != _sections.end()) {
 		if (sectionIt->removeItem(item)) {
+			const auto index = int(sectionIt - _sections.begin());
 			if (sectionIt->empty()) {
 				_sections.erase(sectionIt);
+				_sectionHeights.erase(index);
+			} else {
+				_sectionHeights.set(index, sectionIt->height());
 			}
 			needHeightRefresh = true;
 		}
@@ -548,6 +554,7 @@ void ListWidget::refreshRows() {
 
 	_sections.clear();
 	_sections = _provider->fillSections(this);
+	_sectionHeights.clear();
 
 	if (_controller->isDownloads() && !_sections.empty()) {
 		for (const auto &item : _sections.back().items()) {
@@ -584,21 +591,99 @@ void ListWidget::restoreState(not_null<Memento*> memento) {
 
 int ListWidget::resizeGetHeight(int newWidth) {
 	if (newWidth > 0) {
+		// Sections above the viewport get estimated heights,
+		// so keep the top visible item in place after the resize.
+		if (newWidth != width()) {
+			saveScrollState();
+		}
+		auto heights = std::vector<int>();
+		heights.reserve(_sections.size());
 		for (auto &section : _sections) {
-			section.resizeToWidth(newWidth);
+			section.resizeToWidthLazy(newWidth);
+			heights.push_back(section.height());
+		}
+		_sectionHeights.assign(std::move(heights));
+		validateSectionsAround(_visibleTop, _visibleBottom);
+		if (_scrollTopState.item) {
+			crl::on_main(this, [=] { restoreScrollState(); });
+		}
+	} else if (_sectionHeights.size() != int(_sections.size())) {
+		auto heights = std::vector<int>();
+		heights.reserve(_sections.size());
+		for (const auto &section : _sections) {
+			heights.push_back(section.height());
 		}
+		_sectionHeights.assign(std::move(heights));
 	}
 	return recountHeight();
 }
 
-auto ListWidget::findItemByPoint(QPoint point) const -> FoundItem {
+int ListWidget::sectionTop(int index) const {
+	return padding().top() + _sectionHeights.top(index);
+}
+
+int ListWidget::sectionIndex(const Section &section) const {
+	Expects(!_sections.empty());
+
+	return int(&section - &_sections.front());
+}
+
+bool ListWidget::validateSection(int index) {
+	auto &section = _sections[index];
+	section.setTop(sectionTop(index));
+	if (section.layoutValid()) {
+		return false;
+	}
+	section.validateLayout();
+	_sectionHeights.set(index, section.height());
+	return true;
+}
+
+void ListWidget::validateSectionKeepingScroll(int index) {
+	const auto wasHeight = _sections[index].height();
+	if (!validateSection(index)) {
+		return;
+	}
+	refreshHeight();
+	const auto shift = _sections[index].height() - wasHeight;
+	if (shift && sectionTop(index) + wasHeight <= _visibleTop) {
+		_scrollToRequests.fire(_visibleTop + shift);
+	}
+}
+
+int ListWidget::validateSectionsAround(int top, int bottom) {
+	if (_sections.empty()) {
+		return 0;
+	}
+	const auto margin = kLayoutMarginScreens * std::max(bottom - top, 0);
+	const auto skip = padding().top();
+	const auto count = int(_sections.size());
+	auto shift = 0;
+	auto index = _sectionHeights.findAfterTop(top - margin - skip);
+	for (; index != count; ++index) {
+		const auto sectionTop = this->sectionTop(index);
+		if (sectionTop >= bottom + margin) {
+			break;
+		}
+		const auto wasHeight = _sections[index].height();
+		if (validateSection(index) && (sectionTop + wasHeight <= top)) {
+			// Keep the visible content in place if something above it
+			// got its final layout and changed the estimated height.
+			shift += _sections[index].height() - wasHeight;
+		}
+	}
+	return shift;
+}
+
+auto ListWidget::findItemByPoint(QPoint point) -> FoundItem {
 	Expects(!_sections.empty());
 
 	auto sectionIt = findSectionAfterTop(point.y());
 	if (sectionIt == _sections.end()) {
 		--sectionIt;
 	}
-	auto shift = QPoint(0, sectionIt->top());
+	validateSectionKeepingScroll(sectionIndex(*sectionIt));
+	auto shift = QPoint(0, sectionTop(sectionIndex(*sectionIt)));
 	return foundItemInSection(
 		sectionIt->findItemByPoint(point - shift),
 		*sectionIt);
@@ -611,6 +696,7 @@ auto ListWidget::findItemByItem(const HistoryItem *item)
 	}
 	auto sectionIt = findSectionByItem(item);
 	if (sectionIt != _sections.end()) {
+		validateSectionKeepingScroll(sectionIndex(*sectionIt));
 		if (const auto found = sectionIt->findItemByItem(item)) {
 			return foundItemInSection(*found, *sectionIt);
 		}
@@ -622,6 +708,7 @@ auto ListWidget::findItemDetails(not_null<BaseLayout*> item)
  -> FoundItem {
 	const auto sectionIt = findSectionByItem(item->getItem());
 	Assert(sectionIt != _sections.end());
+	validateSectionKeepingScroll(sectionIndex(*sectionIt));
 	return foundItemInSection(sectionIt->findItemDetails(item), *sectionIt);
 }
 
@@ -629,9 +716,12 @@ auto ListWidget::foundItemInSection(
 	const FoundItem &item,
 	const Section &section) const
 -> FoundItem {
+	Expects(section.layoutValid());
+
+	const auto top = sectionTop(sectionIndex(section));
 	return {
 		item.layout,
-		item.geometry.translated(0, section.top()),
+		item.geometry.translated(0, top),
 		item.exact,
 	};
 }
@@ -642,6 +732,17 @@ void ListWidget::visibleTopBottomUpdated(
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
+	if (const auto shift = validateSectionsAround(visibleTop, visibleBottom)) {
+		refreshHeight();
+		_scrollToRequests.fire(visibleTop + shift);
+		if (_visibleTop != visibleTop) {
+			// Already handled in the nested call after the scroll.
+			return;
+		}
+	} else if (height() != recountHeight()) {
+		refreshHeight();
+	}
+
 	checkMoveToOtherViewer();
 	clearHeavyItems();
 
@@ -732,7 +833,7 @@ void ListWidget::clearHeavyItems() {
 	const auto below = _visibleBottom + visibleHeight;
 	for (auto i = _heavyLayouts.begin(); i != _heavyLayouts.end();) {
 		const auto item = const_cast<BaseLayout*>(i->get());
-		const auto rect = findItemDetails(item).geometry;
+		const auto rect = heavyItemGeometry(item);
 		if (rect.top() + rect.height() <= above || rect.top() >= below) {
 			i = _heavyLayouts.erase(i);
 			item->clearHeavyPart();
@@ -748,7 +849,18 @@ void ListWidget::clearHeavyItems() {
 	}
 }
 
-ListScrollTopState ListWidget::countScrollState() const {
+QRect ListWidget::heavyItemGeometry(not_null<BaseLayout*> item) {
+	const auto sectionIt = findSectionByItem(item->getItem());
+	Assert(sectionIt != _sections.end());
+	if (!sectionIt->layoutValid()) {
+		// Don't lay out a section far away only to unload its items.
+		const auto index = sectionIndex(*sectionIt);
+		return QRect(0, sectionTop(index), width(), sectionIt->height());
+	}
+	return findItemDetails(item).geometry;
+}
+
+ListScrollTopState ListWidget::countScrollState() {
 	if (_sections.empty() || _visibleTop <= 0) {
 		return {};
 	}
@@ -779,6 +891,9 @@ void ListWidget::restoreScrollState() {
 	if (sectionIt == _sections.end()) {
 		--sectionIt;
 	}
+	if (validateSection(sectionIndex(*sectionIt))) {
+		refreshHeight();
+	}
 	const auto found = sectionIt->findItemByItem(_scrollTopState.item);
 	if (!found) {
 		return;
@@ -820,6 +935,10 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 		_dragSelectAction
 	};
 	for (auto it = fromSectionIt; it != tillSectionIt; ++it) {
+		if (!it->layoutValid()) {
+			// Laid out in visibleTopBottomUpdated() before it is shown.
+			continue;
+		}
 		auto top = it->top();
 		p.translate(0, top);
 		it->paint(p, context, clip.translated(0, -top), outerWidth);
@@ -2042,9 +2161,24 @@ void ListWidget::applyDragSelection(SelectedMap &applyTo) const {
 
 void ListWidget::refreshHeight() {
 	resize(width(), recountHeight());
+	refreshVisibleSectionTops();
 	update();
 }
 
+void ListWidget::refreshVisibleSectionTops() {
+	// Painting uses the tops of the sections, so keep the visible ones
+	// in sync with the heights of all the sections above them.
+	const auto count = int(_sections.size());
+	auto index = _sectionHeights.findAfterTop(_visibleTop - padding().top());
+	for (; index < count; ++index) {
+		const auto top = sectionTop(index);
+		if (top >= _visibleBottom) {
+			break;
+		}
+		_sections[index].setTop(top);
+	}
+}
+
 int ListWidget::recountHeight() {
 	if (_sections.empty()) {
 		if (const auto count = _provider->fullCount()) {
@@ -2054,12 +2188,9 @@ int ListWidget::recountHeight() {
 		}
 	}
 	auto cachedPadding = padding();
-	auto result = cachedPadding.top();
-	for (auto &section : _sections) {
-		section.setTop(result);
-		result += section.height();
-	}
-	return result + cachedPadding.bottom();
+	return cachedPadding.top()
+		+ _sectionHeights.total()
+		+ cachedPadding.bottom();
 }
 
 void ListWidget::mouseActionUpdate() {
@@ -2081,31 +2212,22 @@ std::vector<ListSection>::iterator ListWidget::findSectionByItem(
 
 auto ListWidget::findSectionAfterTop(
 		int top) -> std::vector<Section>::iterator {
-	return ranges::lower_bound(
-		_sections,
-		top,
-		std::less_equal<>(),
-		[](const Section &section) { return section.bottom(); });
+	return _sections.begin()
+		+ _sectionHeights.findAfterTop(top - padding().top());
 }
 
 auto ListWidget::findSectionAfterTop(
 		int top) const -> std::vector<Section>::const_iterator {
-	return ranges::lower_bound(
-		_sections,
-		top,
-		std::less_equal<>(),
-		[](const Section &section) { return section.bottom(); });
+	return _sections.begin()
+		+ _sectionHeights.findAfterTop(top - padding().top());
 }
 
 auto ListWidget::findSectionAfterBottom(
 		std::vector<Section>::const_iterator from,
 		int bottom) const -> std::vector<Section>::const_iterator {
-	return ranges::lower_bound(
-		from,
-		_sections.end(),
-		bottom,
-		std::less<>(),
-		[](const Section &section) { return section.top(); });
+	const auto index = _sectionHeights.findAfterBottom(
+		bottom - padding().top());
+	return std::max(from, _sections.begin() + index);
 }
 
 ListWidget::~ListWidget() {
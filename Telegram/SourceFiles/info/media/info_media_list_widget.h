@@ -151,6 +151,12 @@ private:
 	void start();
 	int recountHeight();
 	void refreshHeight();
+	void refreshVisibleSectionTops();
+	[[nodiscard]] int sectionTop(int index) const;
+	[[nodiscard]] int sectionIndex(const Section &section) const;
+	bool validateSection(int index);
+	void validateSectionKeepingScroll(int index);
+	int validateSectionsAround(int top, int bottom);
 	void subscribeToSession(
 		not_null<Main::Session*> session,
 		rpl::lifetime &lifetime);
@@ -229,7 +235,7 @@ private:
 	[[nodiscard]] auto findSectionAfterBottom(
 		std::vector<Section>::const_iterator from,
 		int bottom) const -> std::vector<Section>::const_iterator;
-	[[nodiscard]] FoundItem findItemByPoint(QPoint point) const;
+	[[nodiscard]] FoundItem findItemByPoint(QPoint point);
 	[[nodiscard]] std::optional<FoundItem> findItemByItem(
 		const HistoryItem *item);
 	[[nodiscard]] FoundItem findItemDetails(not_null<BaseLayout*> item);
@@ -237,7 +243,8 @@ private:
 		const FoundItem &item,
 		const Section &section) const;
 
-	[[nodiscard]] ListScrollTopState countScrollState() const;
+	[[nodiscard]] QRect heavyItemGeometry(not_null<BaseLayout*> item);
+	[[nodiscard]] ListScrollTopState countScrollState();
 	void saveScrollState();
 	void restoreScrollState();
 
@@ -279,6 +286,7 @@ private:
 	base::flat_set<not_null<const BaseLayout*>> _heavyLayouts;
 	bool _heavyLayoutsInvalidated = false;
 	std::vector<Section> _sections;
+	ListSectionHeights _sectionHeights;
 
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
@@ -27,6 +27,7 @@ constexpr auto kCaptureSkipDuration = crl::time(400);
 constexpr auto kCaptureFadeInDuration = crl::time(300);
 constexpr auto kCaptureBufferSlice = 256 * 1024;
 constexpr auto kCaptureUpdateDelta = crl::time(100);
+constexpr auto kCaptureEncodedSlice = 16 * 1024;
 
 Instance *CaptureInstance = nullptr;
 
@@ -89,7 +90,8 @@ public:
 		Webrtc::DeviceResolvedId id,
 		Fn<void(Update)> updated,
 		Fn<void()> error,
-		Fn<void(Chunk)> externalProcessing);
+		Fn<void(Chunk)> externalProcessing,
+		Fn<void(QByteArray)> encoded);
 	void stop(Fn<void(Result&&)> callback = nullptr);
 	void pause(bool value, Fn<void(Result&&)> callback);
 
@@ -109,6 +111,7 @@ private:
 	Fn<void(Chunk)> _externalProcessing;
 	Fn<void(Update)> _updated;
 	Fn<void()> _error;
+	Fn<void(QByteArray)> _encoded;
 
 	struct Private;
 	const std::unique_ptr<Private> d;
@@ -146,7 +149,11 @@ void Instance::start(Fn<void(Chunk)> externalProcessing) {
 			crl::on_main(this, [=] {
 				_updates.fire_error(Error::Other);
 			});
-		}, externalProcessing);
+		}, externalProcessing, [=](QByteArray bytes) {
+			crl::on_main(this, [=, bytes = std::move(bytes)] {
+				_encoded.fire_copy(bytes);
+			});
+		});
 		crl::on_main(this, [=] {
 			_started = true;
 		});
@@ -235,6 +242,7 @@ struct Instance::Inner::Private {
 
 	QByteArray data;
 	int32 dataPos = 0;
+	int32 encodedReported = 0;
 
 	int64 waveformMod = 0;
 	int64 waveformEach = (kCaptureFrequency / 100);
@@ -310,10 +318,12 @@ void Instance::Inner::start(
 		Webrtc::DeviceResolvedId id,
 		Fn<void(Update)> updated,
 		Fn<void()> error,
-		Fn<void(Chunk)> externalProcessing) {
+		Fn<void(Chunk)> externalProcessing,
+		Fn<void(QByteArray)> encoded) {
 	_externalProcessing = std::move(externalProcessing);
 	_updated = std::move(updated);
 	_error = std::move(error);
+	_encoded = std::move(encoded);
 	if (_paused) {
 		_paused = false;
 	}
@@ -620,6 +630,7 @@ void Instance::Inner::stop(Fn<void(Result&&)> callback) {
 
 		d->dataPos = 0;
 		d->data.clear();
+		d->encodedReported = 0;
 
 		d->waveformMod = 0;
 		d->waveformPeak = 0;
@@ -712,6 +723,13 @@ void Instance::Inner::process() {
 			memmove(_captured.data(), _captured.constData() + encoded, goodSize);
 			_captured.resize(goodSize);
 		}
+
+		// Let the bytes be uploaded while we're still recording.
+		const auto reported = d->encodedReported;
+		if (_encoded && d->data.size() >= reported + kCaptureEncodedSlice) {
+			d->encodedReported = d->data.size();
+			_encoded(d->data.mid(reported));
+		}
 	} else {
 		DEBUG_LOG(("Audio Capture: no samples to capture."));
 	}
@@ -54,6 +54,11 @@ public:
 		return _updates.events();
 	}
 
+	// Encoded bytes appended to the result since the previous event.
+	[[nodiscard]] rpl::producer<QByteArray> encoded() const {
+		return _encoded.events();
+	}
+
 	[[nodiscard]] bool started() const {
 		return _started.current();
 	}
@@ -72,6 +77,7 @@ private:
 	bool _available = false;
 	rpl::variable<bool> _started = false;
 	rpl::event_stream<Update, Error> _updates;
+	rpl::event_stream<QByteArray> _encoded;
 	QThread _thread;
 	std::unique_ptr<Inner> _inner;
 
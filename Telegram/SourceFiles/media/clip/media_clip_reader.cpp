@@ -33,10 +33,21 @@ namespace Media {
 namespace Clip {
 namespace {
 
-constexpr auto kClipThreadsCount = 8;
-constexpr auto kAverageGifSize = 320 * 240;
+constexpr auto kMaxThreadsCount = 8;
 constexpr auto kWaitBeforeGifPause = crl::time(200);
 
+// Manager load is measured in permille of its thread time.
+constexpr auto kFullLoad = 1000;
+constexpr auto kInitialLoad = 50;
+
+[[nodiscard]] int ThreadsCount() {
+	static const auto result = std::clamp(
+		QThread::idealThreadCount() - 1,
+		2,
+		kMaxThreadsCount);
+	return result;
+}
+
 QImage PrepareFrame(
 		const FrameRequest &request,
 		const QImage &original,
@@ -203,7 +214,7 @@ Reader::Reader(const QByteArray &data, Callback &&callback)
 }
 
 void Reader::init(const Core::FileLocation &location, const QByteArray &data) {
-	if (Workers.size() < kClipThreadsCount) {
+	if (Workers.size() < ThreadsCount()) {
 		_threadIndex = Workers.size();
 		Workers.push_back(std::make_unique<Worker>());
 	} else {
@@ -544,6 +555,8 @@ public:
 	}
 
 	ProcessResult finishProcess(crl::time ms) {
+		const auto started = crl::now();
+		const auto previousFrameWhen = _nextFrameWhen;
 		auto frameMs = _seekPositionMs + ms - _animationStarted;
 		auto readResult = _implementation->readFramesTill(frameMs, ms);
 		if (readResult == internal::ReaderImplementation::ReadResult::EndOfFile) {
@@ -564,9 +577,18 @@ public:
 		if (!renderFrame()) {
 			return error();
 		}
+		frameProcessed(
+			crl::now() - started,
+			_nextFrameWhen - previousFrameWhen);
 		return ProcessResult::CopyFrame;
 	}
 
+	void frameProcessed(crl::time spent, crl::time interval) {
+		const auto load = (spent * kFullLoad)
+			/ std::max(interval, crl::time(1));
+		_load = (_load * 7 + int(std::min(load, crl::time(kFullLoad)))) / 8;
+	}
+
 	bool renderFrame() {
 		Expects(_request.valid());
 
@@ -687,6 +709,8 @@ private:
 	bool _started = false;
 	crl::time _videoPausedAtMs = 0;
 
+	int _load = kInitialLoad;
+
 	friend class Manager;
 
 };
@@ -703,7 +727,7 @@ Manager::Manager(not_null<QThread*> thread) {
 
 void Manager::append(Reader *reader, const Core::FileLocation &location, const QByteArray &data) {
 	reader->_private = new ReaderPrivate(reader, location, data);
-	_loadLevel.fetchAndAddRelaxed(kAverageGifSize);
+	_loadLevel.fetchAndAddRelaxed(reader->_private->_load);
 	update(reader);
 }
 
@@ -783,7 +807,6 @@ bool Manager::handleProcessResult(ReaderPrivate *reader, ProcessResult result, c
 	}
 
 	if (result == ProcessResult::Started) {
-		_loadLevel.fetchAndAddRelaxed(reader->_width * reader->_height - kAverageGifSize);
 		it.key()->_durationMs = reader->_durationMs;
 	}
 	// See if we need to pause GIF because it is not displayed right now.
@@ -826,7 +849,7 @@ bool Manager::handleProcessResult(ReaderPrivate *reader, ProcessResult result, c
 
 Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessResult result, crl::time ms) {
 	if (!handleProcessResult(reader, result, ms)) {
-		_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : kAverageGifSize));
+		_loadLevel.fetchAndAddRelaxed(-reader->_load);
 		delete reader;
 		return ResultHandleRemove;
 	}
@@ -851,7 +874,10 @@ Manager::ResultHandleState Manager::handleResult(ReaderPrivate *reader, ProcessR
 				reader->_frame = index;
 			}
 		}
-		return handleResult(reader, reader->finishProcess(ms), ms);
+		const auto wasLoad = reader->_load;
+		const auto finished = reader->finishProcess(ms);
+		_loadLevel.fetchAndAddRelaxed(reader->_load - wasLoad);
+		return handleResult(reader, finished, ms);
 	}
 
 	return ResultHandleContinue;
@@ -894,39 +920,51 @@ void Manager::process() {
 		checkAllReaders = (_readers.size() > _readerPointers.size());
 	}
 
+	auto due = std::vector<std::pair<crl::time, ReaderPrivate*>>();
 	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
 		ReaderPrivate *reader = i.key();
 		if (i.value() <= ms) {
-			ResultHandleState state = handleResult(reader, reader->process(ms), ms);
-			if (state == ResultHandleRemove) {
-				i = _readers.erase(i);
-				continue;
-			} else if (state == ResultHandleStop) {
-				_processingInThread = nullptr;
-				return;
-			}
-			ms = crl::now();
-			if (reader->_videoPausedAtMs) {
-				i.value() = ms + 86400 * 1000ULL;
-			} else if (reader->_nextFrameWhen && reader->_started) {
-				i.value() = reader->_nextFrameWhen;
-			} else {
-				i.value() = (ms + 86400 * 1000ULL);
-			}
+			due.emplace_back(i.value(), reader);
 		} else if (checkAllReaders) {
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
 			if (it == _readerPointers.cend()) {
-				_loadLevel.fetchAndAddRelaxed(-1 * (reader->_width > 0 ? reader->_width * reader->_height : kAverageGifSize));
+				_loadLevel.fetchAndAddRelaxed(-reader->_load);
 				delete reader;
 				i = _readers.erase(i);
 				continue;
 			}
 		}
-		if (!reader->_autoPausedGif && i.value() < minms) {
+		++i;
+	}
+
+	// The frames that should have been shown the earliest go first.
+	ranges::sort(due, ranges::less(), [](const auto &pair) {
+		return pair.first;
+	});
+	for (const auto &[when, reader] : due) {
+		ResultHandleState state = handleResult(reader, reader->process(ms), ms);
+		if (state == ResultHandleRemove) {
+			_readers.remove(reader);
+			continue;
+		} else if (state == ResultHandleStop) {
+			_processingInThread = nullptr;
+			return;
+		}
+		ms = crl::now();
+		if (reader->_videoPausedAtMs) {
+			_readers[reader] = ms + 86400 * 1000ULL;
+		} else if (reader->_nextFrameWhen && reader->_started) {
+			_readers[reader] = reader->_nextFrameWhen;
+		} else {
+			_readers[reader] = (ms + 86400 * 1000ULL);
+		}
+	}
+
+	for (auto i = _readers.cbegin(), e = _readers.cend(); i != e; ++i) {
+		if (!i.key()->_autoPausedGif && i.value() < minms) {
 			minms = i.value();
 		}
-		++i;
 	}
 
 	ms = crl::now();
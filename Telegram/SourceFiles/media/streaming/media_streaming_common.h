@@ -43,6 +43,10 @@ struct PlaybackOptions {
 	crl::time durationOverride = 0;
 	float64 speed = 1.; // Valid values between 0.5 and 2.
 	AudioMsgId audioId;
+
+	// Largest size the video will be shown at, empty for the full size.
+	QSize surface;
+
 	bool syncVideoByAudio = true;
 	bool waitForMarkAsShown = false;
 	bool hwAllowed = false;
@@ -188,6 +192,11 @@ struct FrameYUV {
 	FrameChannel v;
 };
 
+struct DecodeStats {
+	int64 decodeTime = 0; // In microseconds.
+	int framesDecoded = 0;
+};
+
 struct FrameWithInfo {
 	QImage image;
 	FrameYUV *yuv = nullptr;
@@ -107,6 +107,10 @@ void Document::saveFrameToCover() {
 		: _info.video.cover;
 }
 
+int Document::instancesCount() const {
+	return int(_instances.size());
+}
+
 void Document::registerInstance(not_null<Instance*> instance) {
 	_instances.emplace(instance);
 }
@@ -42,6 +42,7 @@ public:
 	[[nodiscard]] Player &player();
 	[[nodiscard]] const Player &player() const;
 	[[nodiscard]] const Information &info() const;
+	[[nodiscard]] int instancesCount() const;
 
 	[[nodiscard]] bool waitingShown() const;
 	[[nodiscard]] float64 waitingOpacity() const;
@@ -169,14 +169,17 @@ Stream File::Context::initStream(
 			// ignore cover streams
 			return Stream();
 		}
+		result.rotation = FFmpeg::ReadRotationFromMetadata(info);
 		result.codec = FFmpeg::MakeCodecPointer({
 			.stream = info,
 			.hwAllowed = options.hwAllow,
+			.surface = FFmpeg::TransposeSizeByRotation(
+				options.surface,
+				result.rotation),
 		});
 		if (!result.codec) {
 			return result;
 		}
-		result.rotation = FFmpeg::ReadRotationFromMetadata(info);
 		result.aspect = FFmpeg::ValidateAspectRatio(
 			info->sample_aspect_ratio);
 	} else if (type == AVMEDIA_TYPE_AUDIO) {
@@ -24,6 +24,7 @@ class FileDelegate;
 struct StartOptions {
 	crl::time position = 0;
 	crl::time durationOverride = 0;
+	QSize surface;
 	bool seekable = true;
 	bool hwAllow = false;
 };
@@ -551,6 +551,7 @@ void Player::play(const PlaybackOptions &options) {
 	_file->start(delegate(), {
 		.position = _options.position,
 		.durationOverride = options.durationOverride,
+		.surface = _options.surface,
 		.seekable = _options.seekable,
 		.hwAllow = _options.hwAllowed,
 	});
@@ -893,6 +894,14 @@ QSize Player::videoSize() const {
 	return _information.video.size;
 }
 
+QSize Player::videoSurface() const {
+	return _options.surface;
+}
+
+DecodeStats Player::videoDecodeStats() const {
+	return _video ? _video->decodeStats() : DecodeStats();
+}
+
 QImage Player::frame(
 		const FrameRequest &request,
 		const Instance *instance) const {
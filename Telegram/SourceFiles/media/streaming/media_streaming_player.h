@@ -62,6 +62,8 @@ public:
 
 	[[nodiscard]] int64 fileSize() const;
 	[[nodiscard]] QSize videoSize() const;
+	[[nodiscard]] QSize videoSurface() const;
+	[[nodiscard]] DecodeStats videoDecodeStats() const;
 	[[nodiscard]] QImage frame(
 		const FrameRequest &request,
 		const Instance *instance = nullptr) const;
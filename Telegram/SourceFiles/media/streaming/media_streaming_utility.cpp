@@ -12,11 +12,46 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/painter.h"
 #include "ffmpeg/ffmpeg_utility.h"
 
+#include <chrono>
+
 namespace Media {
 namespace Streaming {
 namespace {
 
 constexpr auto kSkipInvalidDataPackets = 10;
+constexpr auto kMaxSwscaleContexts = 4;
+
+[[nodiscard]] int64 MicrosecondsNow() {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+		steady_clock::now().time_since_epoch()).count();
+}
+
+[[nodiscard]] SwsContext *PrepareSwscale(
+		Stream &stream,
+		not_null<AVFrame*> frame,
+		QSize resize) {
+	auto &list = stream.swscales;
+	const auto i = ranges::find_if(list, [&](const auto &existing) {
+		const auto &deleter = existing.get_deleter();
+		return (deleter.srcSize == QSize(frame->width, frame->height))
+			&& (deleter.srcFormat == frame->format)
+			&& (deleter.dstSize == resize);
+	});
+	auto found = (i != end(list)) ? std::move(*i) : FFmpeg::SwscalePointer();
+	if (i != end(list)) {
+		list.erase(i);
+	} else if (list.size() >= kMaxSwscaleContexts) {
+		found = std::move(list.back());
+		list.pop_back();
+	}
+	auto result = FFmpeg::MakeSwscalePointer(frame, resize, &found);
+	if (!result) {
+		return nullptr;
+	}
+	list.insert(begin(list), std::move(result));
+	return list.front().get();
+}
 
 } // namespace
 
@@ -76,6 +111,13 @@ FFmpeg::AvErrorWrap ReadNextFrame(Stream &stream) {
 
 	auto error = FFmpeg::AvErrorWrap();
 
+	const auto started = MicrosecondsNow();
+	const auto guard = gsl::finally([&] {
+		stream.stats.decodeTime += MicrosecondsNow() - started;
+		if (!error) {
+			++stream.stats.framesDecoded;
+		}
+	});
 	do {
 		error = avcodec_receive_frame(
 			stream.codec.get(),
@@ -175,11 +217,8 @@ QImage ConvertFrame(
 			from += deltaFrom;
 		}
 	} else {
-		stream.swscale = MakeSwscalePointer(
-			frame,
-			resize,
-			&stream.swscale);
-		if (!stream.swscale) {
+		const auto swscale = PrepareSwscale(stream, frame, resize);
+		if (!swscale) {
 			return QImage();
 		}
 
@@ -188,7 +227,7 @@ QImage ConvertFrame(
 		int linesize[AV_NUM_DATA_POINTERS] = { int(storage.bytesPerLine()), 0 };
 
 		sws_scale(
-			stream.swscale.get(),
+			swscale,
 			frame->data,
 			frame->linesize,
 			0,
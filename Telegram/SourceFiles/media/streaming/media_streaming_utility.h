@@ -34,6 +34,7 @@ struct Stream {
 	FFmpeg::FramePointer transferredFrame;
 	std::deque<FFmpeg::Packet> queue;
 	int invalidDataPackets = 0;
+	DecodeStats stats;
 
 	// Audio only.
 	int frequency = 0;
@@ -41,7 +42,7 @@ struct Stream {
 	// Video only.
 	int rotation = 0;
 	AVRational aspect = FFmpeg::kNormalAspect;
-	FFmpeg::SwscalePointer swscale;
+	std::vector<FFmpeg::SwscalePointer> swscales; // Most recent first.
 };
 
 [[nodiscard]] crl::time FramePosition(const Stream &stream);
@@ -89,6 +89,7 @@ public:
 		const AudioMsgId &audioId,
 		FnMut<void(const Information &)> ready,
 		Fn<void(Error)> error);
+	~VideoTrackObject();
 
 	void process(std::vector<FFmpeg::Packet> &&packets);
 
@@ -196,6 +197,14 @@ VideoTrackObject::VideoTrackObject(
 	Expects(_error != nullptr);
 }
 
+VideoTrackObject::~VideoTrackObject() {
+	if (const auto frames = _stream.stats.framesDecoded) {
+		DEBUG_LOG(("Video Info: Decoded %1 frames, %2 mcs per frame."
+			).arg(frames
+			).arg(_stream.stats.decodeTime / frames));
+	}
+}
+
 rpl::producer<> VideoTrackObject::checkNextFrame() const {
 	return interrupted()
 		? (rpl::complete<>() | rpl::type_erased())
@@ -378,6 +387,7 @@ auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
 		fail(Error::InvalidData);
 		return FrameResult::Error;
 	}
+	_shared->setDecodeStats(_stream.stats);
 	std::swap(frame->decoded, _stream.decodedFrame);
 	std::swap(frame->transferred, _stream.transferredFrame);
 	frame->index = _frameIndex++;
@@ -725,7 +735,9 @@ void VideoTrackObject::callReady() {
 			.duration = _stream.duration,
 		},
 		.size = FFmpeg::TransposeSizeByRotation(
-			FFmpeg::CorrectByAspect(frame->original.size(), _stream.aspect),
+			FFmpeg::CorrectByAspect(
+				frame->original.size() * (1 << _stream.codec->lowres),
+				_stream.aspect),
 			_stream.rotation),
 		.cover = frame->original,
 		.rotation = _stream.rotation,
@@ -795,6 +807,18 @@ bool VideoTrack::Shared::initialized() const {
 	return (counter() != kCounterUninitialized);
 }
 
+void VideoTrack::Shared::setDecodeStats(const DecodeStats &stats) {
+	_decodeTime.store(stats.decodeTime, std::memory_order_relaxed);
+	_framesDecoded.store(stats.framesDecoded, std::memory_order_relaxed);
+}
+
+DecodeStats VideoTrack::Shared::decodeStats() const {
+	return {
+		.decodeTime = _decodeTime.load(std::memory_order_relaxed),
+		.framesDecoded = _framesDecoded.load(std::memory_order_relaxed),
+	};
+}
+
 not_null<VideoTrack::Frame*> VideoTrack::Shared::getFrame(int index) {
 	Expects(index >= 0 && index < kFramesCount);
 
@@ -1092,6 +1116,10 @@ crl::time VideoTrack::streamDuration() const {
 	return _streamDuration;
 }
 
+DecodeStats VideoTrack::decodeStats() const {
+	return _shared ? _shared->decodeStats() : DecodeStats();
+}
+
 void VideoTrack::process(std::vector<FFmpeg::Packet> &&packets) {
 	_wrapped.with([
 		packets = std::move(packets)
@@ -35,6 +35,7 @@ public:
 	[[nodiscard]] int streamIndex() const;
 	[[nodiscard]] AVRational streamTimeBase() const;
 	[[nodiscard]] crl::time streamDuration() const;
+	[[nodiscard]] DecodeStats decodeStats() const;
 
 	// Called from the same unspecified thread.
 	void process(std::vector<FFmpeg::Packet> &&packets);
@@ -138,6 +139,10 @@ private:
 		[[nodiscard]] not_null<Frame*> frameForPaint();
 		[[nodiscard]] FrameWithIndex frameForPaintWithIndex();
 
+		// Thread-safe.
+		void setDecodeStats(const DecodeStats &stats);
+		[[nodiscard]] DecodeStats decodeStats() const;
+
 	private:
 		[[nodiscard]] not_null<Frame*> getFrame(int index);
 		[[nodiscard]] not_null<const Frame*> getFrame(int index) const;
@@ -153,6 +158,9 @@ private:
 		// (_counter % 2) == 0 crl::queue can read _delay.
 		crl::time _delay = kTimeUnknown;
 
+		std::atomic<int64> _decodeTime = 0;
+		std::atomic<int> _framesDecoded = 0;
+
 	};
 
 	static void PrepareFrameByRequests(
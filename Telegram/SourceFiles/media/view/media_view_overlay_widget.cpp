@@ -125,6 +125,10 @@ constexpr auto kIdsLimit = 48;
 // Preload next messages if we went further from current than that.
 constexpr auto kIdsPreloadAfter = 28;
 
+// Prepare X loaded photos for display in the browsing direction.
+constexpr auto kDecodeAheadCount = 2;
+constexpr auto kDecodeAheadBudget = int64(96 * 1024 * 1024);
+
 constexpr auto kLeftSiblingTextureIndex = 1;
 constexpr auto kRightSiblingTextureIndex = 2;
 constexpr auto kStoriesControlsOpacity = 1.;
@@ -206,6 +210,16 @@ QWidget *PipDelegate::pipParentWidget() {
 		: read.image;
 }
 
+[[nodiscard]] QImage PrepareStaticContentFormat(QImage image) {
+	constexpr auto kGood = QImage::Format_ARGB32_Premultiplied;
+	if (!image.isNull()
+		&& image.format() != kGood
+		&& image.format() != QImage::Format_RGB32) {
+		image = std::move(image).convertToFormat(kGood);
+	}
+	return image;
+}
+
 [[nodiscard]] bool IsSemitransparent(const QImage &image) {
 	if (image.isNull()) {
 		return true;
@@ -1192,19 +1206,40 @@ bool OverlayWidget::documentBubbleShown() const {
 			&& _staticContent.isNull());
 }
 
-void OverlayWidget::setStaticContent(QImage image) {
-	constexpr auto kGood = QImage::Format_ARGB32_Premultiplied;
-	if (!image.isNull()
-		&& image.format() != kGood
-		&& image.format() != QImage::Format_RGB32) {
-		image = std::move(image).convertToFormat(kGood);
-	}
+void OverlayWidget::setStaticContent(
+		QImage image,
+		std::optional<bool> transparent) {
+	image = PrepareStaticContentFormat(std::move(image));
 	image.setDevicePixelRatio(style::DevicePixelRatio());
 	if (_flip) {
 		image = image.mirrored(_flip & Qt::Horizontal, _flip & Qt::Vertical);
 	}
 	_staticContent = std::move(image);
-	_staticContentTransparent = IsSemitransparent(_staticContent);
+	_staticContentTransparent = transparent
+		? *transparent
+		: IsSemitransparent(_staticContent);
+}
+
+bool OverlayWidget::usePreparedPhoto() {
+	if (!_photo) {
+		return false;
+	}
+	const auto i = _preparedPhotos.find(_photo);
+	if (i == end(_preparedPhotos)) {
+		return false;
+	}
+	auto prepared = std::move(i->second);
+	_preparedPhotos.erase(i);
+
+	const auto use = flipSizeByRotation({ _width, _height })
+		* style::DevicePixelRatio();
+	if (prepared.image.size() != use) {
+		return false;
+	}
+	setStaticContent(std::move(prepared.image), prepared.transparent);
+	_blurred = false;
+	finishShownLatency();
+	return true;
 }
 
 bool OverlayWidget::contentShown() const {
@@ -2278,6 +2313,8 @@ void OverlayWidget::clearSession() {
 	_sharedMedia = nullptr;
 	_userPhotos = nullptr;
 	_collage = nullptr;
+	_preparedPhotos.clear();
+	_preparingPhotos.clear();
 	_session = nullptr;
 }
 
@@ -2324,7 +2361,12 @@ void OverlayWidget::assignMediaPointer(not_null<PhotoData*> photo) {
 		_photoMedia = _photo->createMediaView();
 		_photoMedia->wanted(Data::PhotoSize::Small, fileOrigin());
 		if (!_photo->hasVideo() || _photo->videoPlaybackFailed()) {
-			_photo->load(fileOrigin(), LoadFromCloudOrLocal, true);
+			if (_photoMedia->loaded()) {
+				// It may be decoded only for a chat bubble.
+				_photoMedia->wanted(Data::PhotoSize::Large, fileOrigin());
+			} else {
+				_photo->load(fileOrigin(), LoadFromCloudOrLocal, true);
+			}
 		}
 	}
 }
@@ -3480,6 +3522,7 @@ void OverlayWidget::show(OpenRequest request) {
 			Ui::LayerOption::CloseOther,
 			anim::type::instant);
 	}
+	startShownLatency(isHidden());
 	if (photo) {
 		if (contextItem && contextPeer) {
 			return;
@@ -3894,7 +3937,8 @@ void OverlayWidget::startStreamingPlayer(
 
 	const auto &player = _streamed->instance.player();
 	if (player.playing()) {
-		if (!_streamed->withSound) {
+		// Inline previews decode in reduced size, we want the full one.
+		if (!_streamed->withSound && player.videoSurface().isEmpty()) {
 			_streamed->ready = true;
 			return;
 		}
@@ -4801,13 +4845,21 @@ void OverlayWidget::validatePhotoImage(Image *image, bool blurred) {
 		{ .options = (blurred ? Images::Option::Blur : Images::Option()) }
 	).toImage());
 	_blurred = blurred;
+	if (!blurred) {
+		finishShownLatency();
+	}
 }
 
 void OverlayWidget::validatePhotoCurrentImage() {
 	if (!_photo) {
 		return;
+	} else if ((_staticContent.isNull() || _blurred) && usePreparedPhoto()) {
+		return;
 	}
-	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Large), false);
+	const auto large = _photoMedia->image(Data::PhotoSize::Large);
+	validatePhotoImage(
+		large,
+		large && _photoMedia->imageDownscaled(Data::PhotoSize::Large));
 	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Thumbnail), true);
 	validatePhotoImage(_photoMedia->image(Data::PhotoSize::Small), true);
 	validatePhotoImage(_photoMedia->thumbnailInline(), true);
@@ -4845,6 +4897,7 @@ void OverlayWidget::paint(not_null<Renderer*> renderer) {
 		if (videoShown()) {
 			renderer->paintTransformedVideoFrame(contentGeometry());
 			if (_streamed->instance.player().ready()) {
+				finishShownLatency();
 				_streamed->instance.markFrameShown();
 				if (_stories) {
 					_stories->ready();
@@ -5743,6 +5796,9 @@ void OverlayWidget::setSession(not_null<Main::Session*> session) {
 		if (!isHidden()) {
 			updateControls();
 			checkForSaveLoaded();
+			if (_index) {
+				decodeAhead(_decodeAheadDelta);
+			}
 		}
 	}, _sessionLifetime);
 
@@ -5795,6 +5851,7 @@ bool OverlayWidget::moveToEntity(const Entity &entity, int preloadDelta) {
 	}
 	clearStreaming();
 	_streamingStartPaused = false;
+	startShownLatency(false);
 	if (auto photo = std::get_if<not_null<PhotoData*>>(&entity.data)) {
 		displayPhoto(*photo);
 	} else if (auto document = std::get_if<not_null<DocumentData*>>(&entity.data)) {
@@ -5827,6 +5884,10 @@ void OverlayWidget::preloadData(int delta) {
 			const auto &[i, ok] = documents.emplace(
 				(*document)->createMediaView());
 			(*i)->thumbnailWanted(fileOrigin(entity));
+			if ((*document)->isVideoFile()) {
+				// The first frame is shown until the video is ready.
+				(*i)->goodThumbnailWanted();
+			}
 			if (!(*i)->canBePlayed(entity.item)) {
 				(*i)->automaticLoad(fileOrigin(entity), entity.item);
 			}
@@ -5834,6 +5895,93 @@ void OverlayWidget::preloadData(int delta) {
 	}
 	_preloadPhotos = std::move(photos);
 	_preloadDocuments = std::move(documents);
+
+	decodeAhead(delta);
+}
+
+void OverlayWidget::decodeAhead(int delta) {
+	Expects(_index.has_value());
+
+	_decodeAheadDelta = delta;
+	auto wanted = std::vector<not_null<PhotoData*>>();
+	const auto add = [&](int index) {
+		const auto entity = entityByIndex(index);
+		const auto photo = std::get_if<not_null<PhotoData*>>(&entity.data);
+		if (photo && !(*photo)->videoCanBePlayed()) {
+			wanted.push_back(*photo);
+		}
+	};
+	if (delta) {
+		for (auto i = 1; i <= kDecodeAheadCount; ++i) {
+			add(*_index + i * delta);
+		}
+	} else {
+		add(*_index + 1);
+		add(*_index - 1);
+	}
+
+	auto budget = kDecodeAheadBudget;
+	for (auto i = begin(_preparedPhotos); i != end(_preparedPhotos);) {
+		if (i->first == _photo || ranges::contains(wanted, i->first)) {
+			budget -= i->second.image.sizeInBytes();
+			++i;
+		} else {
+			i = _preparedPhotos.erase(i);
+		}
+	}
+	const auto ratio = style::DevicePixelRatio();
+	for (const auto photo : wanted) {
+		if (_preparedPhotos.contains(photo)
+			|| _preparingPhotos.contains(photo)) {
+			continue;
+		}
+		const auto i = ranges::find(
+			_preloadPhotos,
+			photo,
+			&Data::PhotoMedia::owner);
+		const auto image = (i != end(_preloadPhotos))
+			? (*i)->image(Data::PhotoSize::Large)
+			: nullptr;
+		if (!image || (*i)->imageDownscaled(Data::PhotoSize::Large)) {
+			continue;
+		}
+		const auto size = style::ConvertScale(
+			QSize(photo->width(), photo->height())) * ratio;
+		const auto bytes = int64(size.width()) * size.height() * 4;
+		if (size.isEmpty() || bytes > budget) {
+			continue;
+		}
+		budget -= bytes;
+		_preparingPhotos.emplace(photo);
+		const auto weak = Ui::MakeWeak(_widget);
+		crl::async([=, original = image->original()] {
+			auto image = PrepareStaticContentFormat(
+				Images::Prepare(original, size, {}));
+			const auto transparent = IsSemitransparent(image);
+			crl::on_main(weak, [=, image = std::move(image)]() mutable {
+				if (_preparingPhotos.remove(photo)) {
+					_preparedPhotos[photo] = PreparedPhoto{
+						.image = std::move(image),
+						.transparent = transparent,
+					};
+				}
+			});
+		});
+	}
+}
+
+void OverlayWidget::startShownLatency(bool open) {
+	_shownLatencyStart = crl::now();
+	_shownLatencyOpen = open;
+}
+
+void OverlayWidget::finishShownLatency() {
+	if (!_shownLatencyStart) {
+		return;
+	}
+	DEBUG_LOG(("Media View: %1 shown in %2 ms."
+		).arg(_shownLatencyOpen ? "Viewer" : "Next media"
+		).arg(crl::now() - base::take(_shownLatencyStart)));
 }
 
 void OverlayWidget::handleMousePress(
@@ -6505,6 +6653,8 @@ void OverlayWidget::clearBeforeHide() {
 	assignMediaPointer(nullptr);
 	_preloadPhotos.clear();
 	_preloadDocuments.clear();
+	_preparedPhotos.clear();
+	_preparingPhotos.clear();
 	if (_menu) {
 		_menu->hideMenu(true);
 	}
@@ -198,6 +198,10 @@ private:
 		const bool continueStreaming = false;
 		const crl::time startTime = 0;
 	};
+	struct PreparedPhoto {
+		QImage image;
+		bool transparent = false;
+	};
 
 	[[nodiscard]] not_null<QWindow*> window() const;
 	[[nodiscard]] int width() const;
@@ -312,6 +316,9 @@ private:
 	void updateGeometryToScreen(bool inMove = false);
 	bool moveToNext(int delta);
 	void preloadData(int delta);
+	void decodeAhead(int delta);
+	void startShownLatency(bool open);
+	void finishShownLatency();
 
 	void handleScreenChanged(not_null<QScreen*> screen);
 
@@ -522,7 +529,10 @@ private:
 		int rotation) const;
 	[[nodiscard]] bool documentContentShown() const;
 	[[nodiscard]] bool documentBubbleShown() const;
-	void setStaticContent(QImage image);
+	void setStaticContent(
+		QImage image,
+		std::optional<bool> transparent = std::nullopt);
+	bool usePreparedPhoto();
 	[[nodiscard]] bool contentShown() const;
 	[[nodiscard]] bool opaqueContentShown() const;
 	void clearStreaming(bool savePosition = true);
@@ -563,6 +573,11 @@ private:
 	std::shared_ptr<Data::DocumentMedia> _documentMedia;
 	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadPhotos;
 	base::flat_set<std::shared_ptr<Data::DocumentMedia>> _preloadDocuments;
+	base::flat_map<not_null<PhotoData*>, PreparedPhoto> _preparedPhotos;
+	base::flat_set<not_null<PhotoData*>> _preparingPhotos;
+	int _decodeAheadDelta = 0;
+	crl::time _shownLatencyStart = 0;
+	bool _shownLatencyOpen = false;
 	int _rotation = 0;
 	std::unique_ptr<SharedMedia> _sharedMedia;
 	std::optional<SharedMediaWithLastSlice> _sharedMediaData;
@@ -19,7 +19,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/launcher.h"
 #include "chat_helpers/tabbed_panel.h"
+#include "dialogs/dialogs_inner_widget.h"
 #include "dialogs/dialogs_widget.h"
+#include "history/history_inner_widget.h"
 #include "info/profile/info_profile_actions.h"
 #include "lang/lang_keys.h"
 #include "mainwindow.h"
@@ -31,7 +33,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "window/window_session_controller.h"
 #include "window/window_controller.h"
 #include "window/notifications_manager.h"
+#include "storage/file_upload.h"
 #include "storage/localimageloader.h"
+#include "storage/storage_cache_deduplicator.h"
 #include "data/data_document_resolver.h"
 #include "styles/style_settings.h"
 #include "styles/style_layers.h"
@@ -159,6 +163,10 @@ void SetupExperimental(
 	addToggle(Window::kOptionNewWindowsSizeAsFirst);
 	addToggle(MTP::details::kOptionPreferIPv6);
 	addToggle(Window::kOptionDisableTouchbar);
+	addToggle(Storage::kOptionCacheDeduplication);
+	addToggle(Dialogs::kOptionDialogsRowCache);
+	addToggle(Storage::kOptionStreamedVoiceUpload);
+	addToggle(kOptionChatRepaintOverlay);
 }
 
 } // namespace
@@ -13,8 +13,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/random.h"
 
 #include <crl/crl_object_on_thread.h>
-#include <QtCore/QtEndian>
 #include <QtCore/QSaveFile>
+#include <QtCore/QMutex>
 
 namespace Storage {
 namespace details {
@@ -29,7 +29,8 @@ struct WriteEntry {
 	QString basePath;
 	QString base;
 	QByteArray data;
-	QByteArray md5;
+	crl::time scheduled = 0;
+	bool remove = false;
 };
 
 class WriteManager final {
@@ -40,11 +41,15 @@ public:
 	void writeSync(WriteEntry &&entry);
 	void writeSyncAll();
 
+	[[nodiscard]] WriteStats stats() const;
+
 private:
 	void scheduleWrite();
 	void writeScheduled();
 	bool writeOneScheduledNow();
 	void writeNow(WriteEntry &&entry);
+	void writeFile(const WriteEntry &entry);
+	void removeFiles(const WriteEntry &entry);
 
 	template <typename File>
 	[[nodiscard]] bool open(File &file, const WriteEntry &entry, char postfix);
@@ -56,6 +61,7 @@ private:
 
 	crl::weak_on_thread<WriteManager> _weak;
 	std::deque<WriteEntry> _scheduled;
+	WriteStats _stats;
 
 };
 
@@ -63,15 +69,53 @@ class AsyncWriteManager final {
 public:
 	void write(WriteEntry &&entry);
 	void writeSync(WriteEntry &&entry);
+	void remove(const QString &base);
 	void sync();
 	void stop();
 
+	[[nodiscard]] WriteStats stats();
+
 private:
 	std::optional<crl::object_on_thread<WriteManager>> _manager;
 	bool _finished = false;
 
 };
 
+[[nodiscard]] QByteArray CountSignature(const QByteArray &data) {
+	// The data consists of QDataStream-serialized parts, so this is
+	// the same as hashing each part's big-endian length and bytes.
+	auto md5 = HashMd5();
+	md5.feed(data.constData(), data.size());
+	const auto fullSize = int(data.size());
+	md5.feed(&fullSize, sizeof(fullSize));
+	const auto version = qint32(AppVersion);
+	md5.feed(&version, sizeof(version));
+	md5.feed(TdfMagic, TdfMagicLen);
+	return QByteArray((const char*)md5.result(), 0x10);
+}
+
+void CountLatency(WriteLatencyHistogram &histogram, crl::time duration) {
+	auto bucket = 0;
+	while (bucket + 1 < WriteLatencyHistogram::kBuckets
+		&& duration >= (crl::time(1) << bucket)) {
+		++bucket;
+	}
+	++histogram.buckets[bucket];
+	++histogram.count;
+	accumulate_max(histogram.max, duration);
+}
+
+[[nodiscard]] QString FormatLatency(const WriteLatencyHistogram &histogram) {
+	auto buckets = QStringList();
+	for (const auto value : histogram.buckets) {
+		buckets.push_back(QString::number(value));
+	}
+	return u"%1 (max %2 ms) [%3]"_q
+		.arg(histogram.count)
+		.arg(histogram.max)
+		.arg(buckets.join(','));
+}
+
 WriteManager::WriteManager(crl::weak_on_thread<WriteManager> weak)
 : _weak(std::move(weak)) {
 }
@@ -81,7 +125,10 @@ void WriteManager::write(WriteEntry &&entry) {
 	if (i == end(_scheduled)) {
 		_scheduled.push_back(std::move(entry));
 	} else {
+		// Keep the first scheduled time to measure the full latency.
+		entry.scheduled = i->scheduled;
 		*i = std::move(entry);
+		++_stats.coalesced;
 	}
 	scheduleWrite();
 }
@@ -95,15 +142,30 @@ void WriteManager::writeSync(WriteEntry &&entry) {
 }
 
 void WriteManager::writeNow(WriteEntry &&entry) {
+	const auto started = crl::now();
+	if (entry.remove) {
+		removeFiles(entry);
+	} else {
+		writeFile(entry);
+	}
+	const auto finished = crl::now();
+	CountLatency(_stats.disk, finished - started);
+	if (entry.scheduled) {
+		CountLatency(_stats.total, finished - entry.scheduled);
+	}
+}
+
+void WriteManager::writeFile(const WriteEntry &entry) {
 	const auto path = [&](char postfix) {
 		return this->path(entry, postfix);
 	};
 	const auto open = [&](auto &file, char postfix) {
 		return this->open(file, entry, postfix);
 	};
+	const auto md5 = CountSignature(entry.data);
 	const auto write = [&](auto &file) {
 		file.write(entry.data);
-		file.write(entry.md5);
+		file.write(md5);
 	};
 	const auto safe = path('s');
 	const auto simple = path('0');
@@ -135,6 +197,16 @@ void WriteManager::writeNow(WriteEntry &&entry) {
 	}
 }
 
+void WriteManager::removeFiles(const WriteEntry &entry) {
+	QFile::remove(path(entry, '0'));
+	QFile::remove(path(entry, '1'));
+	QFile::remove(path(entry, 's'));
+}
+
+WriteStats WriteManager::stats() const {
+	return _stats;
+}
+
 void WriteManager::writeSyncAll() {
 	while (writeOneScheduledNow()) {
 	}
@@ -218,6 +290,26 @@ void AsyncWriteManager::writeSync(WriteEntry &&entry) {
 	});
 }
 
+void AsyncWriteManager::remove(const QString &base) {
+	if (_finished) {
+		for (const auto postfix : { '0', '1', 's' }) {
+			QFile::remove(base + postfix);
+		}
+		return;
+	}
+	write({ .base = base, .scheduled = crl::now(), .remove = true });
+}
+
+WriteStats AsyncWriteManager::stats() {
+	auto result = WriteStats();
+	if (_manager) {
+		_manager->with_sync([&](WriteManager &manager) {
+			result = manager.stats();
+		});
+	}
+	return result;
+}
+
 void AsyncWriteManager::sync() {
 	if (_manager) {
 		_manager->with_sync([](WriteManager &manager) {
@@ -229,6 +321,11 @@ void AsyncWriteManager::sync() {
 void AsyncWriteManager::stop() {
 	if (_manager) {
 		sync();
+		const auto stats = this->stats();
+		DEBUG_LOG(("Storage Info: Writes %1, total %2, coalesced %3."
+			).arg(FormatLatency(stats.disk)
+			).arg(FormatLatency(stats.total)
+			).arg(stats.coalesced));
 		_manager.reset();
 	}
 	_finished = true;
@@ -236,6 +333,40 @@ void AsyncWriteManager::stop() {
 
 AsyncWriteManager Manager;
 
+struct PrefetchedFile {
+	int32 version = 0;
+	QByteArray data;
+	qint64 position = 0;
+	MTP::AuthKeyPtr key; // Not null if the data is decrypted.
+};
+
+QMutex PrefetchedMutex;
+base::flat_map<QString, PrefetchedFile> Prefetched;
+
+[[nodiscard]] bool TakePrefetched(
+		FileReadDescriptor &result,
+		const QString &path,
+		const MTP::AuthKeyPtr &key) {
+	auto file = PrefetchedFile();
+	{
+		QMutexLocker lock(&PrefetchedMutex);
+		const auto i = Prefetched.find(path);
+		if (i == end(Prefetched) || i->second.key != key) {
+			return false;
+		}
+		file = std::move(i->second);
+		Prefetched.erase(i);
+	}
+	result.version = file.version;
+	result.data = std::move(file.data);
+	result.buffer.setBuffer(&result.data);
+	result.buffer.open(QIODevice::ReadOnly);
+	result.buffer.seek(file.position);
+	result.stream.setDevice(&result.buffer);
+	result.stream.setVersion(QDataStream::Qt_5_1);
+	return true;
+}
+
 } // namespace
 
 QString ToFilePart(FileKey val) {
@@ -280,14 +411,9 @@ FileKey GenerateKey(const QString &basePath) {
 }
 
 void ClearKey(const FileKey &key, const QString &basePath) {
-	QString name;
-	name.reserve(basePath.size() + 0x11);
-	name.append(basePath).append(ToFilePart(key)).append('0');
-	QFile::remove(name);
-	name[name.size() - 1] = '1';
-	QFile::remove(name);
-	name[name.size() - 1] = 's';
-	QFile::remove(name);
+	// Goes through the writer thread, so that it is ordered with
+	// the pending writes of the same key.
+	Manager.remove(basePath + ToFilePart(key));
 }
 
 bool CheckStreamStatus(QDataStream &stream) {
@@ -409,13 +535,6 @@ void FileWriteDescriptor::writeData(const QByteArray &data) {
 		return;
 	}
 	_stream << data;
-	quint32 len = data.isNull() ? 0xffffffff : data.size();
-	if (QSysInfo::ByteOrder != QSysInfo::BigEndian) {
-		len = qbswap(len);
-	}
-	_md5.feed(&len, sizeof(len));
-	_md5.feed(data.constData(), data.size());
-	_fullSize += sizeof(len) + data.size();
 }
 
 void FileWriteDescriptor::writeEncrypted(
@@ -430,18 +549,14 @@ void FileWriteDescriptor::finish() {
 	}
 
 	_stream.setDevice(nullptr);
-	_md5.feed(&_fullSize, sizeof(_fullSize));
-	qint32 version = AppVersion;
-	_md5.feed(&version, sizeof(version));
-	_md5.feed(TdfMagic, TdfMagicLen);
-
 	_buffer.close();
 
+	// The signature is counted in the writer thread.
 	auto entry = WriteEntry{
 		.basePath = _basePath,
 		.base = _base,
 		.data = _safeData,
-		.md5 = QByteArray((const char*)_md5.result(), 0x10)
+		.scheduled = crl::now(),
 	};
 	if (_sync) {
 		Manager.writeSync(std::move(entry));
@@ -476,6 +591,9 @@ bool ReadFile(
 		const QString &name,
 		const QString &basePath) {
 	const auto base = basePath + name;
+	if (TakePrefetched(result, base, nullptr)) {
+		return true;
+	}
 
 	// detect order of read attempts
 	QString toTry[2];
@@ -626,7 +744,9 @@ bool ReadEncryptedFile(
 		const QString &name,
 		const QString &basePath,
 		const MTP::AuthKeyPtr &key) {
-	if (!ReadFile(result, name, basePath)) {
+	if (TakePrefetched(result, basePath + name, key)) {
+		return true;
+	} else if (!ReadFile(result, name, basePath)) {
 		return false;
 	}
 	QByteArray encrypted;
@@ -665,6 +785,41 @@ bool ReadEncryptedFile(
 	return ReadEncryptedFile(result, ToFilePart(fkey), basePath, key);
 }
 
+void PrefetchFile(
+		const QString &name,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key) {
+	auto file = FileReadDescriptor();
+	const auto read = key
+		? ReadEncryptedFile(file, name, basePath, key)
+		: ReadFile(file, name, basePath);
+	if (!read) {
+		return;
+	}
+	const auto position = file.buffer.pos();
+	file.stream.setDevice(nullptr);
+	file.buffer.close();
+	file.buffer.setBuffer(nullptr);
+
+	QMutexLocker lock(&PrefetchedMutex);
+	Prefetched[basePath + name] = PrefetchedFile{
+		.version = file.version,
+		.data = base::take(file.data),
+		.position = position,
+		.key = key,
+	};
+}
+
+void ClearPrefetched() {
+	auto cleared = base::flat_map<QString, PrefetchedFile>();
+	QMutexLocker lock(&PrefetchedMutex);
+	std::swap(cleared, Prefetched);
+}
+
+WriteStats CollectWriteStats() {
+	return Manager.stats();
+}
+
 void Sync() {
 	Manager.sync();
 }
@@ -78,8 +78,6 @@ private:
 	QDataStream _stream;
 	QByteArray _safeData;
 	QString _base;
-	HashMd5 _md5;
-	int _fullSize = 0;
 	bool _sync = false;
 
 };
@@ -106,6 +104,33 @@ bool ReadEncryptedFile(
 	const QString &basePath,
 	const MTP::AuthKeyPtr &key);
 
+// Reads (and decrypts, if the key is not null) the file in the calling
+// thread, so that the next ReadFile / ReadEncryptedFile of the same file
+// with the same key takes the result without touching the disk.
+void PrefetchFile(
+	const QString &name,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key = nullptr);
+void ClearPrefetched();
+
+struct WriteLatencyHistogram {
+	static constexpr auto kBuckets = 12;
+
+	// buckets[i] counts operations faster than (1 << i) ms,
+	// the last one counts all the slower operations.
+	std::array<int64, kBuckets> buckets = { { 0 } };
+	int64 count = 0;
+	crl::time max = 0;
+};
+
+struct WriteStats {
+	WriteLatencyHistogram disk; // Writing a single file.
+	WriteLatencyHistogram total; // From scheduling till written.
+	int64 coalesced = 0;
+};
+
+[[nodiscard]] WriteStats CollectWriteStats();
+
 void Sync();
 void Finish();
 
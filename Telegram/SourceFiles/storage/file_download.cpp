@@ -14,7 +14,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mainwindow.h"
 #include "core/application.h"
 #include "core/file_location.h"
+#include "ui/image/image.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_deduplicator.h"
+#include "storage/storage_cache_policy.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
 #include "platform/platform_file_utilities.h"
@@ -157,14 +160,22 @@ QImage FileLoader::imageData(int progressiveSizeLimit) const {
 	return _imageData;
 }
 
+void FileLoader::setImageDecodeBox(QSize box) {
+	if (_imageDecodeBox != box) {
+		_imageDecodeBox = box;
+		_imageData = QImage();
+	}
+}
+
 void FileLoader::readImage(int progressiveSizeLimit) const {
 	const auto buffer = progressiveSizeLimit
 		? QByteArray::fromRawData(_data.data(), progressiveSizeLimit)
 		: _data;
-	auto read = Images::Read({ .content = buffer });
-	if (!read.image.isNull()) {
-		_imageData = std::move(read.image);
-		_imageFormat = read.format;
+	auto format = QByteArray();
+	auto image = Images::ReadDownscaled(buffer, _imageDecodeBox, &format);
+	if (!image.isNull()) {
+		_imageData = std::move(image);
+		_imageFormat = std::move(format);
 	}
 }
 
@@ -210,7 +221,9 @@ void FileLoader::localLoaded(
 		const QByteArray &imageFormat,
 		const QImage &imageData) {
 	_localLoading = nullptr;
+	auto &policy = _session->data().cachePolicy();
 	if (result.data.isEmpty()) {
+		policy.miss(_cacheTag);
 		_localStatus = LocalStatus::NotFound;
 		start();
 		return;
@@ -218,12 +231,14 @@ void FileLoader::localLoaded(
 	const auto partial = result.data.startsWith("partial:");
 	constexpr auto kPrefix = 8;
 	if (partial	&& result.data.size() < _loadSize + kPrefix) {
+		policy.miss(_cacheTag);
 		_localStatus = LocalStatus::NotFound;
 		if (checkForOpen()) {
 			startLoadingWithPartial(result.data);
 		}
 		return;
 	}
+	policy.hit(cacheKey(), _cacheTag, result.data.size());
 	if (!imageData.isNull()) {
 		_imageFormat = imageFormat;
 		_imageData = imageData;
@@ -264,6 +279,7 @@ bool FileLoader::checkForOpen() {
 
 void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 	const auto readImage = (_locationType != AudioFileLocation);
+	const auto box = _imageDecodeBox;
 	auto done = [=, guard = _localLoading.make_guard()](
 			QByteArray &&value,
 			QImage &&image,
@@ -274,25 +290,32 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 			image = std::move(image),
 			format = std::move(format)
 		]() mutable {
+			if (box != _imageDecodeBox) {
+				// Decode it once again from the bytes in imageData().
+				image = QImage();
+			}
 			localLoaded(
 				StorageImageSaved(std::move(value)),
 				format,
 				std::move(image));
 		});
 	};
-	_session->data().cache().get(key, [=, callback = std::move(done)](
+	auto &cache = _session->data().cacheDeduplicator();
+	cache.get(key, [=, callback = std::move(done)](
 			QByteArray &&value) mutable {
 		if (readImage && !value.startsWith("partial:")) {
 			crl::async([
 				value = std::move(value),
-				done = std::move(callback)
+				done = std::move(callback),
+				box
 			]() mutable {
-				auto read = Images::Read({ .content = value });
-				if (!read.image.isNull()) {
+				auto format = QByteArray();
+				auto image = Images::ReadDownscaled(value, box, &format);
+				if (!image.isNull()) {
 					done(
 						std::move(value),
-						std::move(read.image),
-						std::move(read.format));
+						std::move(image),
+						std::move(format));
 				} else {
 					done(std::move(value), {}, {});
 				}
@@ -458,13 +481,13 @@ bool FileLoader::finalizeResult() {
 		if ((_toCache == LoadToCacheAsWell)
 			&& (_data.size() <= Storage::kMaxFileInMemory)
 			&& (key.low || key.high)) {
-			_session->data().cache().put(
+			_session->data().cacheDeduplicator().put(
 				cacheKey(),
-				Storage::Cache::Database::TaggedValue(
-					base::duplicate((!_fullSize || _data.size() == _fullSize)
-						? _data
-						: ("partial:" + _data)),
-					_cacheTag));
+				base::duplicate((!_fullSize || _data.size() == _fullSize)
+					? _data
+					: ("partial:" + _data)),
+				_cacheTag);
+			_session->data().cachePolicy().stored(_data.size());
 		}
 	}
 	const auto session = _session;
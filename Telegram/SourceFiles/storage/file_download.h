@@ -91,6 +91,12 @@ public:
 		return 0;
 	}
 	[[nodiscard]] QImage imageData(int progressiveSizeLimit = 0) const;
+
+	// Images are decoded right into the size fitting this box.
+	void setImageDecodeBox(QSize box);
+	[[nodiscard]] QSize imageDecodeBox() const {
+		return _imageDecodeBox;
+	}
 	[[nodiscard]] QString fileName() const {
 		return _filename;
 	}
@@ -186,6 +192,7 @@ protected:
 	base::binary_guard _localLoading;
 	mutable QByteArray _imageFormat;
 	mutable QImage _imageData;
+	QSize _imageDecodeBox;
 
 	rpl::lifetime _lifetime;
 	rpl::event_stream<rpl::empty_value, Error> _updates;
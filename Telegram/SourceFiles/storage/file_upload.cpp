@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "api/api_editing.h"
 #include "api/api_send_progress.h"
+#include "base/options.h"
+#include "base/random.h"
 #include "storage/localimageloader.h"
 #include "storage/file_download.h"
 #include "data/data_document.h"
@@ -63,12 +65,23 @@ constexpr auto kSlowRequestThreshold = 8 * crl::time(1000);
 // (it-s size + queued before size) >= 512kb.
 constexpr auto kAcceptAsFastIfTotalAtLeast = 512 * 1024;
 
+// Final size of a recorded voice message is not known in advance.
+constexpr auto kStreamedPartSize = kDocumentUploadPartSize1;
+
+base::options::toggle OptionStreamedVoiceUpload({
+	.id = kOptionStreamedVoiceUpload,
+	.name = "Upload voice messages while recording",
+	.description = "Start uploading a voice message before it is sent.",
+});
+
 [[nodiscard]] const char *ThumbnailFormat(const QString &mime) {
 	return Core::IsMimeSticker(mime) ? "WEBP" : "JPG";
 }
 
 } // namespace
 
+const char kOptionStreamedVoiceUpload[] = "streamed-voice-upload";
+
 struct Uploader::Entry {
 	Entry(FullMsgId itemId, const std::shared_ptr<FilePrepareResult> &file);
 
@@ -88,6 +101,7 @@ struct Uploader::Entry {
 	HashMd5 md5Hash;
 
 	std::unique_ptr<QFile> docFile;
+	uint64 docId = 0;
 	int64 docSize = 0;
 	int64 docSentSize = 0;
 	int docPartSize = 0;
@@ -109,6 +123,13 @@ struct Uploader::Request {
 	bool nonPremiumDelayed = false;
 };
 
+struct Uploader::Streamed {
+	uint64 id = 0;
+	QByteArray bytes;
+	base::flat_set<int> partsDone;
+	int partsSent = 0;
+};
+
 Uploader::Entry::Entry(
 	FullMsgId itemId,
 	const std::shared_ptr<FilePrepareResult> &file)
@@ -121,7 +142,8 @@ Uploader::Entry::Entry(
 , partsOfId((file->type == SendMediaType::Photo
 	|| file->type == SendMediaType::Secure)
 		? file->id
-		: file->thumbId) {
+		: file->thumbId)
+, docId(file->id) {
 	if (file->type == SendMediaType::File
 		|| file->type == SendMediaType::ThemeFile
 		|| file->type == SendMediaType::Audio
@@ -337,11 +359,79 @@ void Uploader::upload(
 		}
 	}
 	_queue.push_back({ itemId, file });
+	if (file->type == SendMediaType::Audio) {
+		useStreamedParts(&_queue.back());
+	}
 	if (!_nextTimer.isActive()) {
 		maybeSend();
 	}
 }
 
+void Uploader::startStreamed() {
+	_streamed = OptionStreamedVoiceUpload.value()
+		? std::make_unique<Streamed>(Streamed{
+			.id = base::RandomValue<uint64>(),
+		})
+		: nullptr;
+}
+
+void Uploader::feedStreamed(const QByteArray &bytes) {
+	if (_streamed) {
+		_streamed->bytes.append(bytes);
+		sendStreamedParts();
+	}
+}
+
+void Uploader::sendStreamedParts() {
+	Expects(_streamed != nullptr);
+
+	const auto id = _streamed->id;
+	const auto &bytes = _streamed->bytes;
+	auto &sent = _streamed->partsSent;
+	while ((sent + 1) * kStreamedPartSize <= bytes.size()) {
+		const auto part = sent++;
+		_api->request(MTPupload_SaveFilePart(
+			MTP_long(id),
+			MTP_int(part),
+			MTP_bytes(bytes.mid(part * kStreamedPartSize, kStreamedPartSize))
+		)).done([=](const MTPBool &result) {
+			if (_streamed && _streamed->id == id && mtpIsTrue(result)) {
+				_streamed->partsDone.emplace(part);
+			}
+		}).send();
+	}
+}
+
+void Uploader::useStreamedParts(not_null<Entry*> entry) {
+	const auto streamed = base::take(_streamed);
+	if (!streamed || entry->docSize > kUseBigFilesFrom) {
+		return;
+	}
+
+	// Only the parts the server has confirmed, and at least one part
+	// is left for the regular upload to finish the file as usual.
+	const auto &content = entry->file->content;
+	auto parts = 0;
+	while (streamed->partsDone.contains(parts)
+		&& (parts + 1) * kStreamedPartSize < content.size()) {
+		++parts;
+	}
+	const auto size = parts * kStreamedPartSize;
+	if (!size
+		|| memcmp(content.constData(), streamed->bytes.constData(), size)) {
+		return;
+	}
+	entry->docId = streamed->id;
+	entry->setPartSize(kStreamedPartSize);
+	entry->docPartsSent = parts;
+	entry->docSentSize = size;
+	entry->md5Hash.feed(content.constData(), size);
+
+	DEBUG_LOG(("Uploader: Reused %1 streamed parts of %2."
+		).arg(parts
+		).arg(entry->docPartsCount));
+}
+
 void Uploader::failed(FullMsgId itemId) {
 	const auto i = ranges::find(_queue, itemId, &Entry::itemId);
 	if (i != end(_queue)) {
@@ -510,13 +600,13 @@ auto Uploader::sendPendingPart(not_null<Entry*> entry, uchar dcIndex)
 	request.dcIndex = dcIndex;
 	if (request.bigPart) {
 		sendPreparedRequest(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(bytes)
 		), std::move(request));
 	} else {
-		const auto id = request.docPart ? entry->file->id : entry->partsOfId;
+		const auto id = request.docPart ? entry->docId : entry->partsOfId;
 		sendPreparedRequest(MTPupload_SaveFilePart(
 			MTP_long(id),
 			MTP_int(part),
@@ -557,14 +647,14 @@ auto Uploader::sendDocPart(not_null<Entry*> entry, uchar dcIndex)
 	};
 	if (entry->docSize > kUseBigFilesFrom) {
 		send(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(partBytes)
 		), true);
 	} else {
 		send(MTPupload_SaveFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docId),
 			MTP_int(part),
 			MTP_bytes(partBytes)
 		), false);
@@ -689,6 +779,7 @@ void Uploader::cancelAllRequests() {
 
 void Uploader::clear() {
 	_queue.clear();
+	_streamed = nullptr;
 	cancelAllRequests();
 	stopSessions();
 	_stopSessionsTimer.cancel();
@@ -872,11 +963,11 @@ void Uploader::finishFront() {
 
 		const auto file = (entry.docSize > kUseBigFilesFrom)
 			? MTP_inputFileBig(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename))
 			: MTP_inputFile(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename),
 				MTP_bytes(docMd5));
@@ -28,6 +28,8 @@ namespace Storage {
 // MTP big files methods used for files greater than 30mb.
 constexpr auto kUseBigFilesFrom = 30 * 1024 * 1024;
 
+extern const char kOptionStreamedVoiceUpload[];
+
 struct UploadedMedia {
 	FullMsgId fullId;
 	Api::RemoteFileInfo info;
@@ -63,6 +65,11 @@ public:
 	void cancel(FullMsgId itemId);
 	void cancelAll();
 
+	// Voice message bytes are uploaded while the message is recorded,
+	// the next voice message upload reuses the matching parts.
+	void startStreamed();
+	void feedStreamed(const QByteArray &bytes);
+
 	[[nodiscard]] rpl::producer<UploadedMedia> photoReady() const {
 		return _photoReady.events();
 	}
@@ -102,6 +109,7 @@ public:
 private:
 	struct Entry;
 	struct Request;
+	struct Streamed;
 
 	enum class SendResult : uchar {
 		Success,
@@ -130,6 +138,9 @@ private:
 	void maybeFinishFront();
 	void finishFront();
 
+	void sendStreamedParts();
+	void useStreamedParts(not_null<Entry*> entry);
+
 	void partLoaded(const MTPBool &result, mtpRequestId requestId);
 	void partFailed(const MTP::Error &error, mtpRequestId requestId);
 	Request finishRequest(mtpRequestId requestId);
@@ -153,6 +164,7 @@ private:
 	const not_null<ApiWrap*> _api;
 
 	std::vector<Entry> _queue;
+	std::unique_ptr<Streamed> _streamed;
 
 	base::flat_map<mtpRequestId, Request> _requests;
 	std::vector<int> _sentPerDcIndex;
@@ -12,16 +12,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/details/storage_file_utilities.h"
 #include "storage/details/storage_settings_scheme.h"
 #include "data/data_session.h"
-#include "data/data_document.h"
-#include "data/data_document_media.h"
 #include "base/platform/base_platform_info.h"
 #include "base/random.h"
 #include "ui/power_saving.h"
 #include "core/update_checker.h"
-#include "core/file_location.h"
 #include "core/application.h"
 #include "core/core_settings.h"
-#include "media/audio/media_audio.h"
 #include "mtproto/mtproto_config.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "main/main_domain.h"
@@ -44,7 +40,6 @@ namespace Local {
 namespace {
 
 constexpr auto kThemeFileSizeLimit = 5 * 1024 * 1024;
-constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
 
 constexpr auto kSavedBackgroundFormat = QImage::Format_ARGB32_Premultiplied;
 constexpr auto kWallPaperLegacySerializeTagId = int32(-111);
@@ -60,7 +55,6 @@ using Database = Storage::Cache::Database;
 
 QString _basePath, _userBasePath, _userDbPath;
 
-TaskQueue *_localLoader = nullptr;
 
 QByteArray _settingsSalt;
 
@@ -342,7 +336,6 @@ void sync() {
 }
 
 void finish() {
-	delete base::take(_localLoader);
 	Storage::details::Finish();
 }
 
@@ -353,8 +346,6 @@ void readLangPack();
 void start() {
 	Expects(_basePath.isEmpty());
 
-	_localLoader = new TaskQueue(kFileLoaderQueueStopTimeout);
-
 	_basePath = cWorkingDir() + u"tdata/"_q;
 	if (!QDir().exists(_basePath)) QDir().mkpath(_basePath);
 
@@ -789,10 +780,6 @@ void moveLegacyBackground(
 }
 
 void reset() {
-	if (_localLoader) {
-		_localLoader->stop();
-	}
-
 	Window::Theme::Background()->reset();
 	_oldSettingsVersion = 0;
 	Core::App().settings().resetOnLastLogout();
@@ -803,76 +790,6 @@ int32 oldSettingsVersion() {
 	return _oldSettingsVersion;
 }
 
-class CountWaveformTask : public Task {
-public:
-	CountWaveformTask(not_null<Data::DocumentMedia*> media)
-	: _doc(media->owner())
-	, _loc(_doc->location(true))
-	, _data(media->bytes())
-	, _wavemax(0) {
-		if (_data.isEmpty() && !_loc.accessEnable()) {
-			_doc = nullptr;
-		}
-	}
-	void process() override {
-		if (!_doc) return;
-
-		_waveform = audioCountWaveform(_loc, _data);
-		_wavemax = _waveform.empty()
-			? char(0)
-			: *ranges::max_element(_waveform);
-	}
-	void finish() override {
-		if (const auto voice = _doc ? _doc->voice() : nullptr) {
-			if (!_waveform.isEmpty()) {
-				voice->waveform = _waveform;
-				voice->wavemax = _wavemax;
-			}
-			if (voice->waveform.isEmpty()) {
-				voice->waveform.resize(1);
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			} else if (voice->waveform[0] < 0) {
-				voice->waveform[0] = -2;
-				voice->wavemax = 0;
-			}
-			_doc->owner().requestDocumentViewRepaint(_doc);
-		}
-	}
-	~CountWaveformTask() {
-		if (_data.isEmpty() && _doc) {
-			_loc.accessDisable();
-		}
-	}
-
-protected:
-	DocumentData *_doc = nullptr;
-	Core::FileLocation _loc;
-	QByteArray _data;
-	VoiceWaveform _waveform;
-	char _wavemax;
-
-};
-
-void countVoiceWaveform(not_null<Data::DocumentMedia*> media) {
-	const auto document = media->owner();
-	if (const auto voice = document->voice()) {
-		if (_localLoader) {
-			voice->waveform.resize(1 + sizeof(TaskId));
-			voice->waveform[0] = -1; // counting
-			TaskId taskId = _localLoader->addTask(
-				std::make_unique<CountWaveformTask>(media));
-			memcpy(voice->waveform.data() + 1, &taskId, sizeof(taskId));
-		}
-	}
-}
-
-void cancelTask(TaskId id) {
-	if (_localLoader) {
-		_localLoader->cancelTask(id);
-	}
-}
-
 Window::Theme::Saved readThemeUsingKey(FileKey key) {
 	using namespace Window::Theme;
 
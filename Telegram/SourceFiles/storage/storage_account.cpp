@@ -49,7 +49,11 @@ constexpr auto kDelayedWriteTimeout = crl::time(1000);
 constexpr auto kWriteSearchSuggestionsDelay = 5 * crl::time(1000);
 
 constexpr auto kStickersVersionTag = quint32(-1);
-constexpr auto kStickersSerializeVersion = 4;
+
+// Sets with bodies in separate blocks use another tag, so that older
+// versions drop such files instead of reading the blocks as stickers.
+constexpr auto kStickersBlocksVersionTag = quint32(-2);
+constexpr auto kStickersSerializeVersion = 5;
 constexpr auto kMaxSavedStickerSetsCount = 1000;
 constexpr auto kDefaultStickerInstallDate = TimeId(1);
 
@@ -96,6 +100,7 @@ enum { // Local Storage Keys
 	lskWebviewTokens = 0x19, // data: QByteArray bots, QByteArray other
 	lskRoundPlaceholder = 0x1a, // no data
 	lskInlineBotsDownloads = 0x1b, // no data
+	lskDialogsSnapshot = 0x1c, // no data
 };
 
 auto EmptyMessageDraftSources()
@@ -182,6 +187,14 @@ std::unique_ptr<MTP::Config> Account::start(MTP::AuthKeyPtr localKey) {
 	return readMtpConfig();
 }
 
+void Account::prefetchStart(const MTP::AuthKeyPtr &localKey) const {
+	Expects(localKey != nullptr);
+
+	PrefetchFile(u"map"_q, _basePath);
+	PrefetchFile(u"config"_q, _basePath, localKey);
+	PrefetchFile(ToFilePart(_dataNameKey), BaseGlobalPath(), localKey);
+}
+
 void Account::startAdded(MTP::AuthKeyPtr localKey) {
 	Expects(localKey != nullptr);
 
@@ -224,6 +237,7 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		_searchSuggestionsKey,
 		_roundPlaceholderKey,
 		_inlineBotsDownloadsKey,
+		_dialogsSnapshotKey,
 	};
 	auto result = base::flat_set<QString>{
 		"map0",
@@ -312,6 +326,7 @@ Account::ReadMapResult Account::readMapWith(
 	quint64 searchSuggestionsKey = 0;
 	quint64 roundPlaceholderKey = 0;
 	quint64 inlineBotsDownloadsKey = 0;
+	quint64 dialogsSnapshotKey = 0;
 	QByteArray webviewStorageTokenBots, webviewStorageTokenOther;
 	while (!map.stream.atEnd()) {
 		quint32 keyType;
@@ -427,6 +442,9 @@ Account::ReadMapResult Account::readMapWith(
 		case lskInlineBotsDownloads: {
 			map.stream >> inlineBotsDownloadsKey;
 		} break;
+		case lskDialogsSnapshot: {
+			map.stream >> dialogsSnapshotKey;
+		} break;
 		case lskWebviewTokens: {
 			map.stream
 				>> webviewStorageTokenBots
@@ -470,6 +488,7 @@ Account::ReadMapResult Account::readMapWith(
 	_searchSuggestionsKey = searchSuggestionsKey;
 	_roundPlaceholderKey = roundPlaceholderKey;
 	_inlineBotsDownloadsKey = inlineBotsDownloadsKey;
+	_dialogsSnapshotKey = dialogsSnapshotKey;
 	_oldMapVersion = mapData.version;
 	_webviewStorageIdBots.token = webviewStorageTokenBots;
 	_webviewStorageIdOther.token = webviewStorageTokenOther;
@@ -586,6 +605,7 @@ void Account::writeMap() {
 	}
 	if (_roundPlaceholderKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_inlineBotsDownloadsKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_dialogsSnapshotKey) mapSize += sizeof(quint32) + sizeof(quint64);
 
 	EncryptedDescriptor mapData(mapSize);
 	if (!self.isEmpty()) {
@@ -664,6 +684,10 @@ void Account::writeMap() {
 		mapData.stream << quint32(lskInlineBotsDownloads);
 		mapData.stream << quint64(_inlineBotsDownloadsKey);
 	}
+	if (_dialogsSnapshotKey) {
+		mapData.stream << quint32(lskDialogsSnapshot);
+		mapData.stream << quint64(_dialogsSnapshotKey);
+	}
 	map.writeEncrypted(mapData, _localKey);
 
 	_mapChanged = false;
@@ -671,6 +695,8 @@ void Account::writeMap() {
 
 void Account::reset() {
 	_writeSearchSuggestionsTimer.cancel();
+	_pendingStickerSets.clear();
+	_documentsDeferred = _documentsMaterialized = 0;
 
 	auto names = collectGoodNames();
 	_draftsMap.clear();
@@ -695,6 +721,7 @@ void Account::reset() {
 	_searchSuggestionsKey = 0;
 	_roundPlaceholderKey = 0;
 	_inlineBotsDownloadsKey = 0;
+	_dialogsSnapshotKey = 0;
 	_oldMapVersion = 0;
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
@@ -1762,49 +1789,76 @@ Cache::Database::Settings Account::cacheBigFileSettings() const {
 	return result;
 }
 
-void Account::writeStickerSet(
+void Account::writeStickerSetInfo(
 		QDataStream &stream,
-		const Data::StickersSet &set) {
-	using SetFlag = Data::StickersSetFlag;
-	const auto writeInfo = [&](int count) {
-		stream
-			<< quint64(set.id)
-			<< quint64(set.accessHash)
-			<< quint64(set.hash)
-			<< set.title
-			<< set.shortName
-			<< qint32(count)
-			<< qint32(set.flags)
-			<< qint32(set.installDate)
-			<< quint64(set.thumbnailDocumentId)
-			<< qint32(set.thumbnailType());
-		Serialize::writeImageLocation(stream, set.thumbnailLocation());
-	};
-	if (set.flags & SetFlag::NotLoaded) {
-		writeInfo(-set.count);
-		return;
-	} else if (set.stickers.isEmpty()) {
-		return;
+		const Data::StickersSet &set,
+		int count) {
+	stream
+		<< quint64(set.id)
+		<< quint64(set.accessHash)
+		<< quint64(set.hash)
+		<< set.title
+		<< set.shortName
+		<< qint32(count)
+		<< qint32(set.flags)
+		<< qint32(set.installDate)
+		<< quint64(set.thumbnailDocumentId)
+		<< qint32(set.thumbnailType());
+	Serialize::writeImageLocation(stream, set.thumbnailLocation());
+}
+
+bool Account::hasStickerSetBody(const Data::StickersSet &set) const {
+	// Sets kept undecoded have no stickers, but still have a body to write.
+	return !set.stickers.isEmpty() || _pendingStickerSets.contains(set.id);
+}
+
+QByteArray Account::serializeStickerSetBody(
+		const Data::StickersSet &set) const {
+	// Sets that were not decoded yet are written back as they were read.
+	if (set.stickers.isEmpty()) {
+		const auto i = _pendingStickerSets.find(set.id);
+		return (i != end(_pendingStickerSets)) ? i->second : QByteArray();
+	}
+
+	// streamAppVersion + count + stickers + datesCount + dates + emojiCount
+	auto size = sizeof(qint32) * 2;
+	for (const auto sticker : std::as_const(set.stickers)) {
+		size += Serialize::Document::sizeInStream(sticker);
+	}
+	size += sizeof(qint32);
+	if (!set.dates.empty()) {
+		Assert(set.stickers.size() == set.dates.size());
+		size += set.dates.size() * sizeof(qint32);
 	}
-
-	writeInfo(set.stickers.size());
-	for (const auto &sticker : set.stickers) {
-		Serialize::Document::writeToStream(stream, sticker);
+	size += sizeof(qint32);
+	for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
+		size += Serialize::stringSize(j->first->id())
+			+ sizeof(qint32)
+			+ (j->second.size() * sizeof(quint64));
 	}
-	stream << qint32(set.dates.size());
-	if (!set.dates.empty()) {
-		Assert(set.dates.size() == set.stickers.size());
+
+	auto result = QByteArray();
+	result.reserve(int(size));
+	{
+		QDataStream stream(&result, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << qint32(AppVersion) << qint32(set.stickers.size());
+		for (const auto &sticker : set.stickers) {
+			Serialize::Document::writeToStream(stream, sticker);
+		}
+		stream << qint32(set.dates.size());
 		for (const auto date : set.dates) {
 			stream << qint32(date);
 		}
-	}
-	stream << qint32(set.emoji.size());
-	for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
-		stream << j->first->id() << qint32(j->second.size());
-		for (const auto sticker : j->second) {
-			stream << quint64(sticker->id);
+		stream << qint32(set.emoji.size());
+		for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
+			stream << j->first->id() << qint32(j->second.size());
+			for (const auto sticker : j->second) {
+				stream << quint64(sticker->id);
+			}
 		}
 	}
+	return result;
 }
 
 // In generic method _writeStickerSets() we look through all the sets and call a
@@ -1833,10 +1887,17 @@ void Account::writeStickerSets(
 		return;
 	}
 
+	struct Entry {
+		not_null<const Data::StickersSet*> set;
+		QByteArray body;
+		int count = 0;
+	};
+	auto list = std::vector<Entry>();
+	list.reserve(sets.size());
+
 	// versionTag + version + count
 	quint32 size = sizeof(quint32) + sizeof(qint32) + sizeof(qint32);
 
-	int32 setsCount = 0;
 	for (const auto &[id, set] : sets) {
 		const auto raw = set.get();
 		auto result = checkSet(*raw);
@@ -1845,6 +1906,18 @@ void Account::writeStickerSets(
 		} else if (result == StickerSetCheckResult::Skip) {
 			continue;
 		}
+		auto entry = Entry{ .set = raw };
+		if (raw->flags & SetFlag::NotLoaded) {
+			entry.count = -raw->count;
+		} else {
+			entry.body = serializeStickerSetBody(*raw);
+			if (entry.body.isEmpty()) {
+				continue;
+			}
+			entry.count = raw->stickers.isEmpty()
+				? raw->count
+				: int(raw->stickers.size());
+		}
 
 		// id
 		// + accessHash
@@ -1857,35 +1930,18 @@ void Account::writeStickerSets(
 		// + thumbnailDocumentId
 		// + thumbnailType
 		// + thumbnailLocation
+		// + body
 		size += sizeof(quint64) * 3
 			+ Serialize::stringSize(raw->title)
 			+ Serialize::stringSize(raw->shortName)
 			+ sizeof(qint32) * 3
 			+ sizeof(quint64)
 			+ sizeof(qint32)
-			+ Serialize::imageLocationSize(raw->thumbnailLocation());
-		if (raw->flags & SetFlag::NotLoaded) {
-			continue;
-		}
-
-		for (const auto sticker : std::as_const(raw->stickers)) {
-			size += Serialize::Document::sizeInStream(sticker);
-		}
-
-		size += sizeof(qint32); // datesCount
-		if (!raw->dates.empty()) {
-			Assert(raw->stickers.size() == raw->dates.size());
-			size += raw->dates.size() * sizeof(qint32);
-		}
-
-		size += sizeof(qint32); // emojiCount
-		for (auto j = raw->emoji.cbegin(), e = raw->emoji.cend(); j != e; ++j) {
-			size += Serialize::stringSize(j->first->id()) + sizeof(qint32) + (j->second.size() * sizeof(quint64));
-		}
-
-		++setsCount;
+			+ Serialize::imageLocationSize(raw->thumbnailLocation())
+			+ Serialize::bytearraySize(entry.body);
+		list.push_back(std::move(entry));
 	}
-	if (!setsCount && order.isEmpty()) {
+	if (list.empty() && order.isEmpty()) {
 		if (stickersKey) {
 			ClearKey(stickersKey, _basePath);
 			stickersKey = 0;
@@ -1895,23 +1951,29 @@ void Account::writeStickerSets(
 	}
 	size += sizeof(qint32) + (order.size() * sizeof(quint64));
 
+	for (const auto setId : order) {
+		const auto written = ranges::contains(
+			list,
+			setId,
+			[](const Entry &entry) { return entry.set->id; });
+		if (!written && _pendingStickerSets.contains(setId)) {
+			LOG(("Stickers Error: Pending set %1 was not written."
+				).arg(setId));
+		}
+	}
+
 	if (!stickersKey) {
 		stickersKey = GenerateKey(_basePath);
 		writeMapQueued();
 	}
 	EncryptedDescriptor data(size);
 	data.stream
-		<< quint32(kStickersVersionTag)
+		<< quint32(kStickersBlocksVersionTag)
 		<< qint32(kStickersSerializeVersion)
-		<< qint32(setsCount);
-	for (const auto &[id, set] : sets) {
-		auto result = checkSet(*set);
-		if (result == StickerSetCheckResult::Abort) {
-			return;
-		} else if (result == StickerSetCheckResult::Skip) {
-			continue;
-		}
-		writeStickerSet(data.stream, *set);
+		<< qint32(list.size());
+	for (const auto &entry : list) {
+		writeStickerSetInfo(data.stream, *entry.set, entry.count);
+		data.stream << entry.body;
 	}
 	data.stream << order;
 
@@ -1922,7 +1984,8 @@ void Account::writeStickerSets(
 void Account::readStickerSets(
 		FileKey &stickersKey,
 		Data::StickersSetsOrder *outOrder,
-		Data::StickersSetFlags readingFlags) {
+		Data::StickersSetFlags readingFlags,
+		bool lazy) {
 	using SetFlag = Data::StickersSetFlag;
 
 	FileReadDescriptor stickers;
@@ -1944,7 +2007,13 @@ void Account::readStickerSets(
 	quint32 versionTag = 0;
 	qint32 version = 0;
 	stickers.stream >> versionTag >> version;
-	if (versionTag != kStickersVersionTag || version < 2) {
+	if (versionTag == kStickersBlocksVersionTag) {
+		if (version < 5) {
+			return failed();
+		}
+	} else if (versionTag != kStickersVersionTag
+		|| version < 2
+		|| version > 4) {
 		// Old data, without sticker set thumbnails.
 		return failed();
 	}
@@ -1989,6 +2058,10 @@ void Account::readStickerSets(
 		const auto thumbnail = Serialize::readImageLocation(
 			stickers.version,
 			stickers.stream);
+		auto body = QByteArray();
+		if (version > 4) {
+			stickers.stream >> body;
+		}
 		if (!thumbnail || !CheckStreamStatus(stickers.stream)) {
 			return failed();
 		} else if (thumbnail->valid() && thumbnail->isLegacy()) {
@@ -2034,8 +2107,8 @@ void Account::readStickerSets(
 			it->second->thumbnailDocumentId = setThumbnailDocumentId;
 		}
 		const auto set = it->second.get();
-		const auto inputSet = set->identifier();
-		const auto fillStickers = set->stickers.isEmpty();
+		const auto fillStickers = set->stickers.isEmpty()
+			&& !_pendingStickerSets.contains(setId);
 
 		if (scnt < 0) { // disabled not loaded set
 			if (!set->count || fillStickers) {
@@ -2044,87 +2117,22 @@ void Account::readStickerSets(
 			continue;
 		}
 
-		if (fillStickers) {
-			set->stickers.reserve(scnt);
-			set->count = 0;
-		}
-
-		Serialize::Document::StickerSetInfo info(
-			setId,
-			setAccessHash,
-			setShortName);
-		base::flat_set<DocumentId> read;
-		for (int32 j = 0; j < scnt; ++j) {
-			auto document = Serialize::Document::readStickerFromStream(
-				&_owner->session(),
-				stickers.version,
-				stickers.stream, info);
-			if (!CheckStreamStatus(stickers.stream)) {
+		if (version < 5) {
+			if (!readStickerSetBody(
+					set,
+					stickers.stream,
+					stickers.version,
+					scnt,
+					fillStickers)) {
 				return failed();
-			} else if (!document
-				|| !document->sticker()
-				|| read.contains(document->id)) {
-				continue;
 			}
-			read.emplace(document->id);
-			if (fillStickers) {
-				set->stickers.push_back(document);
-				if (!(set->flags & SetFlag::Special)) {
-					if (!document->sticker()->set.id) {
-						document->sticker()->set = inputSet;
-					}
-				}
-				++set->count;
-			}
-		}
-
-		qint32 datesCount = 0;
-		stickers.stream >> datesCount;
-		if (datesCount > 0) {
-			if (datesCount != scnt) {
-				return failed();
-			}
-			const auto fillDates
-				= ((set->id == Data::Stickers::CloudRecentSetId)
-					|| (set->id == Data::Stickers::CloudRecentAttachedSetId))
-				&& (set->stickers.size() == datesCount);
-			if (fillDates) {
-				set->dates.clear();
-				set->dates.reserve(datesCount);
-			}
-			for (auto i = 0; i != datesCount; ++i) {
-				qint32 date = 0;
-				stickers.stream >> date;
-				if (fillDates) {
-					set->dates.push_back(TimeId(date));
-				}
-			}
-		}
-
-		qint32 emojiCount = 0;
-		stickers.stream >> emojiCount;
-		if (!CheckStreamStatus(stickers.stream) || emojiCount < 0) {
-			return failed();
-		}
-		for (int32 j = 0; j < emojiCount; ++j) {
-			QString emojiString;
-			qint32 stickersCount;
-			stickers.stream >> emojiString >> stickersCount;
-			Data::StickersPack pack;
-			pack.reserve(stickersCount);
-			for (int32 k = 0; k < stickersCount; ++k) {
-				quint64 id;
-				stickers.stream >> id;
-				const auto doc = _owner->session().data().document(id);
-				if (!doc->sticker()) continue;
-
-				pack.push_back(doc);
-			}
-			if (fillStickers) {
-				if (auto emoji = Ui::Emoji::Find(emojiString)) {
-					emoji = emoji->original();
-					set->emoji[emoji] = std::move(pack);
-				}
+		} else if (fillStickers) {
+			if (lazy && !(set->flags & SetFlag::Special)) {
+				set->count = scnt;
+				_documentsDeferred += scnt;
+				_pendingStickerSets[setId] = std::move(body);
+			} else if (!readStickerSetBody(set, body)) {
+				set->flags |= SetFlag::NotLoaded;
 			}
 		}
 
@@ -2171,6 +2179,10 @@ void Account::readStickerSets(
 		return failed();
 	}
 
+	DEBUG_LOG(("Stickers Info: %1 documents read, %2 deferred."
+		).arg(_documentsMaterialized
+		).arg(_documentsDeferred));
+
 	// Set flags that we dropped above from the order.
 	if (readingFlags && outOrder) {
 		for (const auto setId : std::as_const(*outOrder)) {
@@ -2187,17 +2199,174 @@ void Account::readStickerSets(
 	}
 }
 
+bool Account::readStickerSetBody(
+		not_null<Data::StickersSet*> set,
+		QDataStream &stream,
+		int streamAppVersion,
+		int count,
+		bool fill) {
+	using SetFlag = Data::StickersSetFlag;
+
+	const auto owner = &_owner->session().data();
+	const auto inputSet = set->identifier();
+	if (fill) {
+		set->stickers.reserve(count);
+		set->count = 0;
+	}
+
+	Serialize::Document::StickerSetInfo info(
+		set->id,
+		set->accessHash,
+		set->shortName);
+	base::flat_set<DocumentId> read;
+	for (int32 j = 0; j < count; ++j) {
+		auto document = Serialize::Document::readStickerFromStream(
+			&_owner->session(),
+			streamAppVersion,
+			stream,
+			info);
+		if (!CheckStreamStatus(stream)) {
+			return false;
+		} else if (!document
+			|| !document->sticker()
+			|| read.contains(document->id)) {
+			continue;
+		}
+		read.emplace(document->id);
+		++_documentsMaterialized;
+		if (fill) {
+			set->stickers.push_back(document);
+			if (!(set->flags & SetFlag::Special)) {
+				if (!document->sticker()->set.id) {
+					document->sticker()->set = inputSet;
+				}
+			}
+			++set->count;
+		}
+	}
+
+	qint32 datesCount = 0;
+	stream >> datesCount;
+	if (datesCount > 0) {
+		if (datesCount != count) {
+			return false;
+		}
+		const auto fillDates
+			= ((set->id == Data::Stickers::CloudRecentSetId)
+				|| (set->id == Data::Stickers::CloudRecentAttachedSetId))
+			&& (set->stickers.size() == datesCount);
+		if (fillDates) {
+			set->dates.clear();
+			set->dates.reserve(datesCount);
+		}
+		for (auto i = 0; i != datesCount; ++i) {
+			qint32 date = 0;
+			stream >> date;
+			if (fillDates) {
+				set->dates.push_back(TimeId(date));
+			}
+		}
+	}
+
+	qint32 emojiCount = 0;
+	stream >> emojiCount;
+	if (!CheckStreamStatus(stream) || emojiCount < 0) {
+		return false;
+	}
+	for (int32 j = 0; j < emojiCount; ++j) {
+		QString emojiString;
+		qint32 stickersCount;
+		stream >> emojiString >> stickersCount;
+		Data::StickersPack pack;
+		pack.reserve(stickersCount);
+		for (int32 k = 0; k < stickersCount; ++k) {
+			quint64 id;
+			stream >> id;
+			const auto doc = owner->document(id);
+			if (!doc->sticker()) continue;
+
+			pack.push_back(doc);
+		}
+		if (fill) {
+			if (auto emoji = Ui::Emoji::Find(emojiString)) {
+				emoji = emoji->original();
+				set->emoji[emoji] = std::move(pack);
+			}
+		}
+	}
+	return CheckStreamStatus(stream);
+}
+
+bool Account::readStickerSetBody(
+		not_null<Data::StickersSet*> set,
+		const QByteArray &body) {
+	QDataStream stream(body);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	auto streamAppVersion = qint32();
+	auto count = qint32();
+	stream >> streamAppVersion >> count;
+	if (!CheckStreamStatus(stream)
+		|| streamAppVersion <= 0
+		|| streamAppVersion > AppVersion
+		|| count < 0) {
+		return false;
+	}
+	return readStickerSetBody(set, stream, streamAppVersion, count, true)
+		&& stream.atEnd();
+}
+
+void Account::decodePendingStickerSet(
+		uint64 setId,
+		const QByteArray &body) {
+	const auto &sets = _owner->session().data().stickers().sets();
+	const auto i = sets.find(setId);
+	if (i == end(sets) || !i->second->stickers.isEmpty()) {
+		return;
+	}
+	_documentsDeferred -= i->second->count;
+	if (!readStickerSetBody(i->second.get(), body)) {
+		// Request it from the server as any other not loaded set.
+		i->second->flags |= Data::StickersSetFlag::NotLoaded;
+	}
+}
+
+bool Account::hasPendingStickerSet(uint64 setId) const {
+	return _pendingStickerSets.contains(setId);
+}
+
+void Account::readPendingStickerSet(uint64 setId) {
+	const auto i = _pendingStickerSets.find(setId);
+	if (i == end(_pendingStickerSets)) {
+		return;
+	}
+	const auto body = std::move(i->second);
+	_pendingStickerSets.erase(i);
+	decodePendingStickerSet(setId, body);
+}
+
+void Account::readPendingStickerSets() {
+	if (_pendingStickerSets.empty()) {
+		return;
+	}
+	for (const auto &[setId, body] : base::take(_pendingStickerSets)) {
+		decodePendingStickerSet(setId, body);
+	}
+	DEBUG_LOG(("Stickers Info: Pending sets read, %1 documents total."
+		).arg(_documentsMaterialized));
+}
+
 void Account::writeInstalledStickers() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_installedStickersKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_installedStickersKey, [this](const Data::StickersSet &set) {
 		if (set.id == Data::Stickers::CloudRecentSetId
 			|| set.id == Data::Stickers::FavedSetId
 			|| set.id == Data::Stickers::CloudRecentAttachedSetId) {
 			// separate files for them
 			return StickerSetCheckResult::Skip;
 		} else if (set.flags & SetFlag::Special) {
-			if (set.stickers.isEmpty()) { // all other special are "installed"
+			if (!hasStickerSetBody(set)) { // all other special are "installed"
 				return StickerSetCheckResult::Skip;
 			}
 		} else if (!(set.flags & SetFlag::Installed)
@@ -2207,7 +2376,7 @@ void Account::writeInstalledStickers() {
 		} else if (set.flags & SetFlag::NotLoaded) {
 			// waiting to receive
 			return StickerSetCheckResult::Abort;
-		} else if (set.stickers.isEmpty()) {
+		} else if (!hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2217,7 +2386,7 @@ void Account::writeInstalledStickers() {
 void Account::writeFeaturedStickers() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_featuredStickersKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_featuredStickersKey, [this](const Data::StickersSet &set) {
 		if (set.id == Data::Stickers::CloudRecentSetId
 			|| set.id == Data::Stickers::FavedSetId
 			|| set.id == Data::Stickers::CloudRecentAttachedSetId) {
@@ -2229,7 +2398,7 @@ void Account::writeFeaturedStickers() {
 			return StickerSetCheckResult::Skip;
 		} else if (set.flags & SetFlag::NotLoaded) { // waiting to receive
 			return StickerSetCheckResult::Abort;
-		} else if (set.stickers.isEmpty()) {
+		} else if (!hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2239,13 +2408,13 @@ void Account::writeFeaturedStickers() {
 void Account::writeFeaturedCustomEmoji() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_featuredCustomEmojiKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_featuredCustomEmojiKey, [this](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Featured)
 			|| (set.type() != Data::StickersType::Emoji)) {
 			return StickerSetCheckResult::Skip;
 		} else if (set.flags & SetFlag::NotLoaded) { // waiting to receive
 			return StickerSetCheckResult::Abort;
-		} else if (set.stickers.isEmpty()) {
+		} else if (!hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2253,9 +2422,9 @@ void Account::writeFeaturedCustomEmoji() {
 }
 
 void Account::writeRecentStickers() {
-	writeStickerSets(_recentStickersKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_recentStickersKey, [this](const Data::StickersSet &set) {
 		if (set.id != Data::Stickers::CloudRecentSetId
-			|| set.stickers.isEmpty()) {
+			|| !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2263,8 +2432,8 @@ void Account::writeRecentStickers() {
 }
 
 void Account::writeFavedStickers() {
-	writeStickerSets(_favedStickersKey, [](const Data::StickersSet &set) {
-		if (set.id != Data::Stickers::FavedSetId || set.stickers.isEmpty()) {
+	writeStickerSets(_favedStickersKey, [this](const Data::StickersSet &set) {
+		if (set.id != Data::Stickers::FavedSetId || !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2274,10 +2443,10 @@ void Account::writeFavedStickers() {
 void Account::writeArchivedStickers() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_archivedStickersKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_archivedStickersKey, [this](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Archived)
 			|| (set.type() != Data::StickersType::Stickers)
-			|| set.stickers.isEmpty()) {
+			|| !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2287,10 +2456,10 @@ void Account::writeArchivedStickers() {
 void Account::writeArchivedMasks() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_archivedStickersKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_archivedStickersKey, [this](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Archived)
 			|| (set.type() != Data::StickersType::Masks)
-			|| set.stickers.isEmpty()) {
+			|| !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2300,11 +2469,11 @@ void Account::writeArchivedMasks() {
 void Account::writeInstalledMasks() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_installedMasksKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_installedMasksKey, [this](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Installed)
 			|| (set.flags & SetFlag::Archived)
 			|| (set.type() != Data::StickersType::Masks)
-			|| set.stickers.isEmpty()) {
+			|| !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2312,9 +2481,9 @@ void Account::writeInstalledMasks() {
 }
 
 void Account::writeRecentMasks() {
-	writeStickerSets(_recentMasksKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_recentMasksKey, [this](const Data::StickersSet &set) {
 		if (set.id != Data::Stickers::CloudRecentAttachedSetId
-			|| set.stickers.isEmpty()) {
+			|| !hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2324,7 +2493,7 @@ void Account::writeRecentMasks() {
 void Account::writeInstalledCustomEmoji() {
 	using SetFlag = Data::StickersSetFlag;
 
-	writeStickerSets(_installedCustomEmojiKey, [](const Data::StickersSet &set) {
+	writeStickerSets(_installedCustomEmojiKey, [this](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Installed)
 			|| (set.flags & SetFlag::Archived)
 			|| (set.type() != Data::StickersType::Emoji)) {
@@ -2332,7 +2501,7 @@ void Account::writeInstalledCustomEmoji() {
 		} else if (set.flags & SetFlag::NotLoaded) {
 			// waiting to receive
 			return StickerSetCheckResult::Abort;
-		} else if (set.stickers.isEmpty()) {
+		} else if (!hasStickerSetBody(set)) {
 			return StickerSetCheckResult::Skip;
 		}
 		return StickerSetCheckResult::Write;
@@ -2465,17 +2634,21 @@ void Account::readInstalledStickers() {
 	}
 
 	_owner->session().data().stickers().setsRef().clear();
+	_pendingStickerSets.clear();
+	_documentsDeferred = 0;
 	readStickerSets(
 		_installedStickersKey,
 		&_owner->session().data().stickers().setsOrderRef(),
-		Data::StickersSetFlag::Installed);
+		Data::StickersSetFlag::Installed,
+		true);
 }
 
 void Account::readFeaturedStickers() {
 	readStickerSets(
 		_featuredStickersKey,
 		&_owner->session().data().stickers().featuredSetsOrderRef(),
-		Data::StickersSetFlag::Featured);
+		Data::StickersSetFlag::Featured,
+		true);
 
 	const auto &sets = _owner->session().data().stickers().sets();
 	const auto &order = _owner->session().data().stickers().featuredSetsOrder();
@@ -2535,7 +2708,8 @@ void Account::readInstalledMasks() {
 	readStickerSets(
 		_installedMasksKey,
 		&_owner->session().data().stickers().maskSetsOrderRef(),
-		Data::StickersSetFlag::Installed);
+		Data::StickersSetFlag::Installed,
+		true);
 }
 
 void Account::readInstalledCustomEmoji() {
@@ -2574,6 +2748,10 @@ void Account::writeSavedGifs() {
 }
 
 void Account::readSavedGifs() {
+	if (_savedGifsRead) {
+		return;
+	}
+	_savedGifsRead = true;
 	if (!_savedGifsKey) return;
 
 	FileReadDescriptor gifs;
@@ -2612,6 +2790,10 @@ void Account::readSavedGifs() {
 
 		saved.push_back(document);
 	}
+	_documentsMaterialized += saved.size();
+	DEBUG_LOG(("Stickers Info: %1 saved GIFs read, %2 documents total."
+		).arg(saved.size()
+		).arg(_documentsMaterialized));
 }
 
 void Account::writeRecentHashtagsAndBots() {
@@ -3290,6 +3472,52 @@ void Account::writeInlineBotsDownloads(const QByteArray &bytes) {
 	file.writeEncrypted(data, _localKey);
 }
 
+QByteArray Account::readDialogsSnapshot() {
+	if (_dialogsSnapshotRead) {
+		return QByteArray();
+	}
+	_dialogsSnapshotRead = true;
+	if (!_dialogsSnapshotKey) {
+		return QByteArray();
+	}
+
+	FileReadDescriptor dialogsSnapshot;
+	if (!ReadEncryptedFile(
+			dialogsSnapshot,
+			_dialogsSnapshotKey,
+			_basePath,
+			_localKey)) {
+		ClearKey(_dialogsSnapshotKey, _basePath);
+		_dialogsSnapshotKey = 0;
+		writeMapDelayed();
+		return QByteArray();
+	}
+
+	auto bytes = QByteArray();
+	dialogsSnapshot.stream >> bytes;
+	return bytes;
+}
+
+void Account::writeDialogsSnapshot(const QByteArray &bytes) {
+	if (bytes.isEmpty()) {
+		if (_dialogsSnapshotKey) {
+			ClearKey(_dialogsSnapshotKey, _basePath);
+			_dialogsSnapshotKey = 0;
+			writeMapDelayed();
+		}
+		return;
+	}
+	if (!_dialogsSnapshotKey) {
+		_dialogsSnapshotKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	quint32 size = Serialize::bytearraySize(bytes);
+	EncryptedDescriptor data(size);
+	data.stream << bytes;
+	FileWriteDescriptor file(_dialogsSnapshotKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
 bool Account::encrypt(
 		const void *src,
 		void *dst,
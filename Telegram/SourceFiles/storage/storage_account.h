@@ -70,6 +70,9 @@ public:
 	[[nodiscard]] StartResult legacyStart(const QByteArray &passcode);
 	[[nodiscard]] std::unique_ptr<MTP::Config> start(
 		MTP::AuthKeyPtr localKey);
+
+	// Thread-safe, reads ahead the files that start() decrypts.
+	void prefetchStart(const MTP::AuthKeyPtr &localKey) const;
 	void startAdded(MTP::AuthKeyPtr localKey);
 	[[nodiscard]] int oldMapVersion() const {
 		return _oldMapVersion;
@@ -141,6 +144,11 @@ public:
 	void readInstalledCustomEmoji();
 	void readFeaturedCustomEmoji();
 
+	// Regular sets are decoded from storage when their stickers are used.
+	[[nodiscard]] bool hasPendingStickerSet(uint64 setId) const;
+	void readPendingStickerSet(uint64 setId);
+	void readPendingStickerSets();
+
 	void writeRecentHashtagsAndBots();
 	void readRecentHashtagsAndBots();
 	void saveRecentSentHashtags(const QString &text);
@@ -180,6 +188,9 @@ public:
 	[[nodiscard]] QByteArray readInlineBotsDownloads();
 	void writeInlineBotsDownloads(const QByteArray &bytes);
 
+	[[nodiscard]] QByteArray readDialogsSnapshot();
+	void writeDialogsSnapshot(const QByteArray &bytes);
+
 	[[nodiscard]] bool encrypt(
 		const void *src,
 		void *dst,
@@ -243,9 +254,14 @@ private:
 		details::FileReadDescriptor &draft,
 		quint64 draftPeerSerialized);
 
-	void writeStickerSet(
+	void writeStickerSetInfo(
 		QDataStream &stream,
-		const Data::StickersSet &set);
+		const Data::StickersSet &set,
+		int count);
+	[[nodiscard]] bool hasStickerSetBody(
+		const Data::StickersSet &set) const;
+	[[nodiscard]] QByteArray serializeStickerSetBody(
+		const Data::StickersSet &set) const;
 	template <typename CheckSet>
 	void writeStickerSets(
 		FileKey &stickersKey,
@@ -254,7 +270,18 @@ private:
 	void readStickerSets(
 		FileKey &stickersKey,
 		Data::StickersSetsOrder *outOrder = nullptr,
-		Data::StickersSetFlags readingFlags = 0);
+		Data::StickersSetFlags readingFlags = 0,
+		bool lazy = false);
+	[[nodiscard]] bool readStickerSetBody(
+		not_null<Data::StickersSet*> set,
+		QDataStream &stream,
+		int streamAppVersion,
+		int count,
+		bool fill);
+	[[nodiscard]] bool readStickerSetBody(
+		not_null<Data::StickersSet*> set,
+		const QByteArray &body);
+	void decodePendingStickerSet(uint64 setId, const QByteArray &body);
 	void importOldRecentStickers();
 
 	void readTrustedBots();
@@ -310,6 +337,7 @@ private:
 	FileKey _searchSuggestionsKey = 0;
 	FileKey _roundPlaceholderKey = 0;
 	FileKey _inlineBotsDownloadsKey = 0;
+	FileKey _dialogsSnapshotKey = 0;
 
 	qint64 _cacheTotalSizeLimit = 0;
 	qint64 _cacheBigFileTotalSizeLimit = 0;
@@ -322,6 +350,15 @@ private:
 	bool _recentHashtagsAndBotsWereRead = false;
 	bool _searchSuggestionsRead = false;
 	bool _inlineBotsDownloadsRead = false;
+	bool _dialogsSnapshotRead = false;
+
+	base::flat_map<uint64, QByteArray> _pendingStickerSets;
+	bool _savedGifsRead = false;
+
+	// Documents created from the stored sticker sets and saved GIFs
+	// and the ones that are still kept serialized in pending sets.
+	int64 _documentsMaterialized = 0;
+	int64 _documentsDeferred = 0;
 
 	Webview::StorageId _webviewStorageIdBots;
 	Webview::StorageId _webviewStorageIdOther;
@@ -0,0 +1,244 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_cache_deduplicator.h"
+
+#include "base/openssl_help.h"
+#include "base/options.h"
+#include "data/data_types.h"
+#include "storage/cache/storage_cache_database.h"
+
+namespace Storage {
+namespace {
+
+// Small files are not worth an index entry and an extra read.
+constexpr auto kMinDeduplicatedSize = 16 * 1024;
+constexpr auto kHashSize = 32;
+
+const auto kAliasPrefix = QByteArray("alias:");
+const auto kPartialPrefix = QByteArray("partial:");
+
+using TaggedValue = Cache::Database::TaggedValue;
+
+struct Target {
+	Cache::Key key;
+	int64 size = 0;
+};
+
+base::options::toggle OptionCacheDeduplication({
+	.id = kOptionCacheDeduplication,
+	.name = "Deduplicate cached files",
+	.description = "Store files with equal contents in the cache only once.",
+});
+
+void Append(QByteArray &to, uint64 value) {
+	to.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+[[nodiscard]] uint64 Read(const QByteArray &from, int offset) {
+	auto result = uint64();
+	memcpy(&result, from.constData() + offset, sizeof(result));
+	return result;
+}
+
+[[nodiscard]] QByteArray SerializeTarget(
+		const QByteArray &prefix,
+		const Target &target) {
+	auto result = QByteArray();
+	result.reserve(prefix.size() + 3 * sizeof(uint64));
+	result.append(prefix);
+	Append(result, target.key.high);
+	Append(result, target.key.low);
+	Append(result, uint64(target.size));
+	return result;
+}
+
+[[nodiscard]] std::optional<Target> ParseTarget(
+		const QByteArray &prefix,
+		const QByteArray &value) {
+	if (value.size() != prefix.size() + 3 * sizeof(uint64)
+		|| !value.startsWith(prefix)) {
+		return std::nullopt;
+	}
+	const auto offset = int(prefix.size());
+	return Target{
+		.key = {
+			Read(value, offset),
+			Read(value, offset + sizeof(uint64)),
+		},
+		.size = int64(Read(value, offset + 2 * sizeof(uint64))),
+	};
+}
+
+[[nodiscard]] int AliasSize() {
+	return kAliasPrefix.size() + 3 * sizeof(uint64);
+}
+
+[[nodiscard]] Cache::Key StatsKey() {
+	return Data::ContentHashCacheKey(QByteArray());
+}
+
+} // namespace
+
+const char kOptionCacheDeduplication[] = "cache-deduplication";
+
+CacheDeduplicator::CacheDeduplicator(not_null<Cache::Database*> database)
+: _database(database) {
+}
+
+CacheDeduplicator::~CacheDeduplicator() = default;
+
+void CacheDeduplicator::put(
+		const Cache::Key &key,
+		QByteArray value,
+		uint8 tag) {
+	const auto size = int64(value.size());
+	if (!OptionCacheDeduplication.value()
+		|| size < kMinDeduplicatedSize
+		|| value.startsWith(kPartialPrefix)) {
+		_database->put(key, TaggedValue(std::move(value), tag));
+		return;
+	}
+
+	// Keep the full value until we know there is a copy to point at.
+	_database->put(key, TaggedValue(QByteArray(value), tag));
+	crl::async([=, weak = base::make_weak(this)] {
+		const auto digest = openssl::Sha256(bytes::make_span(value));
+		auto serialized = QByteArray(
+			reinterpret_cast<const char*>(digest.data()),
+			digest.size());
+		crl::on_main(weak, [=, hash = std::move(serialized)] {
+			deduplicate(key, hash, size, tag);
+		});
+	});
+}
+
+void CacheDeduplicator::deduplicate(
+		const Cache::Key &key,
+		QByteArray hash,
+		int64 size,
+		uint8 tag) {
+	Expects(hash.size() == kHashSize);
+
+	const auto index = Data::ContentHashCacheKey(hash);
+	const auto weak = base::make_weak(this);
+	const auto registerKey = [=] {
+		_database->put(index, TaggedValue(
+			SerializeTarget(hash, { .key = key, .size = size }),
+			tag));
+	};
+	_database->get(index, [=](QByteArray &&value) {
+		crl::on_main(weak, [=, value = std::move(value)] {
+			const auto target = ParseTarget(hash, value);
+			if (!target || target->size != size) {
+				registerKey();
+				return;
+			} else if (target->key == key) {
+				return;
+			}
+			// Make sure the shared bytes were not evicted meanwhile.
+			_database->getWithSizes(index, { target->key }, [=](
+					QByteArray &&,
+					std::vector<int> &&sizes) {
+				const auto found = !sizes.empty() && (sizes.front() == size);
+				crl::on_main(weak, [=] {
+					if (!found) {
+						registerKey();
+						return;
+					}
+					addSavedBytes(size - AliasSize());
+					_database->put(key, TaggedValue(
+						SerializeTarget(kAliasPrefix, *target),
+						tag));
+				});
+			});
+		});
+	});
+}
+
+void CacheDeduplicator::get(
+		const Cache::Key &key,
+		FnMut<void(QByteArray&&)> done) {
+	const auto weak = base::make_weak(this);
+	_database->get(key, [=, done = std::move(done)](
+			QByteArray &&value) mutable {
+		const auto alias = ParseTarget(kAliasPrefix, value);
+		if (!alias) {
+			done(std::move(value));
+			return;
+		}
+		crl::on_main(weak, [=, done = std::move(done)]() mutable {
+			resolve(key, alias->key, alias->size, std::move(done));
+		});
+	});
+}
+
+void CacheDeduplicator::resolve(
+		const Cache::Key &key,
+		const Cache::Key &target,
+		int64 size,
+		FnMut<void(QByteArray&&)> done) {
+	const auto weak = base::make_weak(this);
+	_database->get(target, [=, done = std::move(done)](
+			QByteArray &&value) mutable {
+		if (value.size() != size) {
+			crl::on_main(weak, [=] {
+				dropAlias(key, size);
+			});
+			done(QByteArray());
+			return;
+		}
+		done(std::move(value));
+	});
+}
+
+void CacheDeduplicator::dropAlias(const Cache::Key &key, int64 size) {
+	addSavedBytes(AliasSize() - size);
+	_database->remove(key);
+}
+
+rpl::producer<int64> CacheDeduplicator::savedBytesValue() {
+	readStats();
+	return _savedBytes.value();
+}
+
+void CacheDeduplicator::readStats() {
+	if (_statsRead) {
+		return;
+	}
+	_statsRead = true;
+	_database->get(StatsKey(), [=, weak = base::make_weak(this)](
+			QByteArray &&value) {
+		const auto stored = (value.size() == sizeof(uint64))
+			? int64(Read(value, 0))
+			: int64(0);
+		crl::on_main(weak, [=] {
+			_statsLoaded = true;
+			if (stored > 0) {
+				addSavedBytes(stored);
+			} else if (_savedBytes.current() > 0) {
+				writeStats();
+			}
+		});
+	});
+}
+
+void CacheDeduplicator::addSavedBytes(int64 delta) {
+	readStats();
+	_savedBytes = std::max(_savedBytes.current() + delta, int64(0));
+	if (_statsLoaded) {
+		writeStats();
+	}
+}
+
+void CacheDeduplicator::writeStats() {
+	auto serialized = QByteArray();
+	Append(serialized, uint64(_savedBytes.current()));
+	_database->put(StatsKey(), std::move(serialized));
+}
+
+} // namespace Storage
@@ -0,0 +1,61 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+#include "storage/cache/storage_cache_types.h"
+
+namespace Storage {
+namespace Cache {
+class Database;
+} // namespace Cache
+
+extern const char kOptionCacheDeduplication[];
+
+// Stores downloaded files with equal contents in the cache only once.
+//
+// The first key put with some content keeps the bytes and is registered
+// in the content hash index, other keys with the same content get a small
+// alias value pointing to the first one. Reading an alias reads the first
+// key as well, so the shared bytes stay fresh while any alias is in use.
+// If they were evicted anyway the alias is dropped as a cache miss.
+class CacheDeduplicator final : public base::has_weak_ptr {
+public:
+	explicit CacheDeduplicator(not_null<Cache::Database*> database);
+	~CacheDeduplicator();
+
+	void put(const Cache::Key &key, QByteArray value, uint8 tag);
+	void get(const Cache::Key &key, FnMut<void(QByteArray&&)> done);
+
+	// Approximate, aliases evicted by the database are not tracked.
+	[[nodiscard]] rpl::producer<int64> savedBytesValue();
+
+private:
+	void deduplicate(
+		const Cache::Key &key,
+		QByteArray hash,
+		int64 size,
+		uint8 tag);
+	void resolve(
+		const Cache::Key &key,
+		const Cache::Key &target,
+		int64 size,
+		FnMut<void(QByteArray&&)> done);
+	void dropAlias(const Cache::Key &key, int64 size);
+	void readStats();
+	void writeStats();
+	void addSavedBytes(int64 delta);
+
+	const not_null<Cache::Database*> _database;
+	rpl::variable<int64> _savedBytes = 0;
+	bool _statsRead = false;
+	bool _statsLoaded = false;
+
+};
+
+} // namespace Storage
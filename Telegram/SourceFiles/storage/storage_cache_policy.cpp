@@ -0,0 +1,164 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_cache_policy.h"
+
+#include "data/data_types.h"
+#include "storage/storage_cache_deduplicator.h"
+
+namespace Storage {
+namespace {
+
+constexpr auto kMegabyte = int64(1024 * 1024);
+constexpr auto kProtectAfterStored = 128 * kMegabyte;
+constexpr auto kMaxProtectedSize = int64(512 * 1024);
+constexpr auto kMaxEntries = 4096;
+constexpr auto kFrequentHits = 2;
+constexpr auto kStalePasses = 2;
+constexpr auto kMaxReadPerPass = 8 * kMegabyte;
+
+} // namespace
+
+CachePolicy::CachePolicy(not_null<CacheDeduplicator*> cache)
+: _cache(cache) {
+}
+
+CachePolicy::~CachePolicy() = default;
+
+int64 CachePolicy::TagProtectLimit(uint8 tag) {
+	switch (tag) {
+	case Data::kImageCacheTag: return 64 * kMegabyte;
+	case Data::kStickerCacheTag: return 64 * kMegabyte;
+	case Data::kVoiceMessageCacheTag: return 16 * kMegabyte;
+	}
+	return 0;
+}
+
+void CachePolicy::hit(const Cache::Key &key, uint8 tag, int64 size) {
+	++_stats[tag].hits;
+	if (size > kMaxProtectedSize || !TagProtectLimit(tag)) {
+		return;
+	}
+	auto &entry = _entries[key];
+	entry.size = size;
+	entry.tag = tag;
+	entry.pass = _pass;
+	++entry.hits;
+	if (_entries.size() > kMaxEntries) {
+		trim();
+	}
+}
+
+void CachePolicy::miss(uint8 tag) {
+	++_stats[tag].misses;
+}
+
+void CachePolicy::stored(int64 size) {
+	_storedSinceProtect += size;
+	if (_storedSinceProtect >= kProtectAfterStored) {
+		_storedSinceProtect = 0;
+		protect();
+	}
+}
+
+auto CachePolicy::tagStats(uint8 tag) const -> TagStats {
+	const auto i = _stats.find(tag);
+	return (i != end(_stats)) ? i->second : TagStats();
+}
+
+void CachePolicy::trim() {
+	// Keep the more popular half, the counters are aged in protect().
+	auto hits = _entries | ranges::views::transform([](const auto &pair) {
+		return pair.second.hits;
+	}) | ranges::to_vector;
+	const auto middle = begin(hits) + kMaxEntries / 2;
+	ranges::nth_element(hits, middle, ranges::greater());
+	const auto threshold = *middle;
+
+	// Entries with the threshold count fill what is left of the half,
+	// so equal counts don't drop all the entries or keep all of them.
+	auto equal = kMaxEntries / 2 - int(ranges::count_if(hits, [&](int x) {
+		return x > threshold;
+	}));
+	for (auto i = begin(_entries); i != end(_entries);) {
+		if (i->second.hits > threshold
+			|| (i->second.hits == threshold && equal-- > 0)) {
+			++i;
+		} else {
+			i = _entries.erase(i);
+		}
+	}
+}
+
+void CachePolicy::age() {
+	// Once per pass, so that old popularity fades away.
+	for (auto i = begin(_entries); i != end(_entries);) {
+		if (i->second.hits /= 2) {
+			++i;
+		} else {
+			i = _entries.erase(i);
+		}
+	}
+}
+
+void CachePolicy::protect() {
+	// Entries read or refreshed in the last two passes are fresh enough.
+	const auto stale = [&](const Entry &entry) {
+		return (_pass - entry.pass) >= kStalePasses;
+	};
+	auto frequent = std::vector<std::pair<Cache::Key, Entry>>();
+	for (const auto &[key, entry] : _entries) {
+		if (entry.hits >= kFrequentHits) {
+			frequent.emplace_back(key, entry);
+		}
+	}
+	ranges::sort(frequent, [](const auto &a, const auto &b) {
+		return (a.second.hits != b.second.hits)
+			? (a.second.hits > b.second.hits)
+			: (a.second.size < b.second.size);
+	});
+
+	// The database has no way to mark an entry as used without reading
+	// it, so the reads are limited per pass and spent on the entries
+	// that weren't used for the longest time.
+	auto used = base::flat_map<uint8, int64>();
+	auto refresh = std::vector<std::pair<Cache::Key, Entry>>();
+	for (const auto &[key, entry] : frequent) {
+		auto &bytes = used[entry.tag];
+		if (bytes + entry.size > TagProtectLimit(entry.tag)) {
+			continue;
+		}
+		bytes += entry.size;
+		if (stale(entry)) {
+			refresh.emplace_back(key, entry);
+		}
+	}
+	ranges::stable_sort(refresh, ranges::less(), [](const auto &pair) {
+		return pair.second.pass;
+	});
+
+	auto read = int64();
+	auto touched = 0;
+	for (const auto &[key, entry] : refresh) {
+		if (read + entry.size > kMaxReadPerPass) {
+			break;
+		}
+		read += entry.size;
+		++touched;
+		_cache->get(key, [](QByteArray&&) {});
+		_entries[key].pass = _pass + 1;
+	}
+	++_pass;
+	age();
+
+	DEBUG_LOG(("Cache Policy: Refreshed %1 (%2 bytes) of %3 frequent files."
+		).arg(touched
+		).arg(read
+		).arg(frequent.size()));
+}
+
+} // namespace Storage
@@ -0,0 +1,66 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+#include "storage/cache/storage_cache_types.h"
+
+namespace Storage {
+
+class CacheDeduplicator;
+
+// Protects small, frequently used cached files from being evicted by
+// a burst of large downloads.
+//
+// The database evicts the least recently used entries of all tags
+// together, so after enough new data was stored the files that were read
+// at least twice recently and weren't used for a while are read once
+// more, up to the protect limit of their cache tag and a small read
+// budget per pass. The limits don't evict anything, they only bound how
+// much of each tag is kept fresh. Files of the tags without a limit
+// (round videos, GIFs, documents) are not touched.
+//
+// Hits and misses per tag are accounting only, for the storage box.
+class CachePolicy final : public base::has_weak_ptr {
+public:
+	struct TagStats {
+		int64 hits = 0;
+		int64 misses = 0;
+	};
+
+	explicit CachePolicy(not_null<CacheDeduplicator*> cache);
+	~CachePolicy();
+
+	void hit(const Cache::Key &key, uint8 tag, int64 size);
+	void miss(uint8 tag);
+	void stored(int64 size);
+
+	[[nodiscard]] TagStats tagStats(uint8 tag) const;
+	[[nodiscard]] static int64 TagProtectLimit(uint8 tag);
+
+private:
+	struct Entry {
+		int64 size = 0;
+		int hits = 0;
+		int pass = 0;
+		uint8 tag = 0;
+	};
+
+	void trim();
+	void age();
+	void protect();
+
+	const not_null<CacheDeduplicator*> _cache;
+	base::flat_map<Cache::Key, Entry> _entries;
+	base::flat_map<uint8, TagStats> _stats;
+	int64 _storedSinceProtect = 0;
+	int _pass = 0;
+
+};
+
+} // namespace Storage
@@ -9,6 +9,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "storage/details/storage_file_utilities.h"
 #include "storage/serialize_common.h"
+#include "storage/storage_account.h"
+#include "core/application.h"
+#include "core/startup_timeline.h"
 #include "mtproto/mtproto_config.h"
 #include "main/main_domain.h"
 #include "main/main_account.h"
@@ -29,6 +32,47 @@ using namespace details;
 	return "key_" + dataName;
 }
 
+struct AccountToStart {
+	int index = 0;
+	bool last = false;
+	std::unique_ptr<Main::Account> account;
+	crl::time prefetched = 0;
+};
+
+// The local key is shared, so the account files can be read and
+// decrypted in parallel, only parsing them is left to the main thread.
+void PrefetchAccounts(
+		std::vector<AccountToStart> &list,
+		const MTP::AuthKeyPtr &localKey) {
+	const auto prefetch = [=](not_null<AccountToStart*> entry) {
+		auto step = Core::App().startupTimeline().step("account_prefetch");
+		const auto started = crl::now();
+		entry->account->local().prefetchStart(localKey);
+		entry->prefetched = crl::now() - started;
+	};
+	if (list.size() < 2) {
+		for (auto &entry : list) {
+			prefetch(&entry);
+		}
+		return;
+	}
+	struct State {
+		crl::semaphore semaphore;
+		std::atomic<int> left = 0;
+	};
+	const auto state = std::make_shared<State>();
+	state->left = int(list.size());
+	for (auto &entry : list) {
+		crl::async([=, entry = &entry] {
+			prefetch(entry);
+			if (!--state->left) {
+				state->semaphore.release();
+			}
+		});
+	}
+	state->semaphore.acquire();
+}
+
 } // namespace
 
 Domain::Domain(not_null<Main::Domain*> owner, const QString &dataName)
@@ -168,35 +212,55 @@ Domain::StartModernResult Domain::startModern(
 	_oldVersion = keyData.version;
 
 	auto tried = base::flat_set<int>();
-	auto sessions = base::flat_set<uint64>();
-	auto active = 0;
+	auto list = std::vector<AccountToStart>();
 	for (auto i = 0; i != count; ++i) {
 		auto index = qint32();
 		info.stream >> index;
 		if (index >= 0
 			&& index < Main::Domain::kPremiumMaxAccounts
 			&& tried.emplace(index).second) {
-			auto account = std::make_unique<Main::Account>(
-				_owner,
-				_dataName,
-				index);
-			auto config = account->prepareToStart(_localKey);
-			const auto sessionId = account->willHaveSessionUniqueId(
-				config.get());
-			if (!sessions.contains(sessionId)
-				&& (sessionId != 0 || (sessions.empty() && i + 1 == count))) {
-				if (sessions.empty()) {
-					active = index;
-				}
-				account->start(std::move(config));
-				_owner->accountAddedInStorage({
-					.index = index,
-					.account = std::move(account)
-				});
-				sessions.emplace(sessionId);
+			list.push_back({
+				.index = index,
+				.last = (i + 1 == count),
+				.account = std::make_unique<Main::Account>(
+					_owner,
+					_dataName,
+					index),
+			});
+		}
+	}
+	PrefetchAccounts(list, _localKey);
+
+	auto sessions = base::flat_set<uint64>();
+	auto active = 0;
+	for (auto &[index, last, account, prefetched] : list) {
+		auto step = Core::App().startupTimeline().step("account_start");
+		const auto started = crl::now();
+		auto config = account->prepareToStart(_localKey);
+		const auto read = crl::now();
+		const auto sessionId = account->willHaveSessionUniqueId(
+			config.get());
+		if (!sessions.contains(sessionId)
+			&& (sessionId != 0 || (sessions.empty() && last))) {
+			if (sessions.empty()) {
+				active = index;
 			}
+			account->start(std::move(config));
+			_owner->accountAddedInStorage({
+				.index = index,
+				.account = std::move(account)
+			});
+			sessions.emplace(sessionId);
 		}
+		LOG(("App Info: account %1 storage prefetched in %2 ms, "
+			"read in %3 ms, started in %4 ms."
+			).arg(index
+			).arg(prefetched
+			).arg(read - started
+			).arg(crl::now() - read));
 	}
+	ClearPrefetched();
+
 	if (sessions.empty()) {
 		LOG(("App Error: no accounts read."));
 		return StartModernResult::Failed;
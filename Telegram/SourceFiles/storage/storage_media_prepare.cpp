@@ -28,6 +28,8 @@ using Ui::PreparedList;
 
 using Image = PreparedFileInformation::Image;
 
+constexpr auto kPreviewFastScaleFactor = 4;
+
 bool ValidPhotoForAlbum(
 		const Image &image,
 		const QString &mime) {
@@ -219,7 +221,7 @@ PreparedList PrepareMediaList(
 			result.files.back().size = filesize;
 		} else {
 			result.filesToProcess.emplace_back(file);
-			result.files.back().size = filesize;
+			result.filesToProcess.back().size = filesize;
 		}
 	}
 	PrepareDetailsInParallel(result, previewWidth);
@@ -343,6 +345,13 @@ void UpdateImageDetails(
 		previewWidth,
 		style::ConvertScale(preview.width())
 	) * style::DevicePixelRatio();
+	if (preview.width() > kPreviewFastScaleFactor * toWidth) {
+		// Smooth scaling cost depends on the source size, so bring huge
+		// photos close to the displayed size with a cheap scaling first.
+		preview = preview.scaledToWidth(
+			kPreviewFastScaleFactor * toWidth,
+			Qt::FastTransformation);
+	}
 	auto scaled = preview.scaledToWidth(
 		toWidth,
 		Qt::SmoothTransformation);
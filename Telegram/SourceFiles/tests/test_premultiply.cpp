@@ -0,0 +1,206 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "ffmpeg/ffmpeg_utility.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QImage>
+#include <QtGui/qrgb.h>
+
+#include <cstdio>
+
+// Checks FFmpeg::PremultiplyInplace and FFmpeg::UnPremultiply against
+// qPremultiply / qUnpremultiply for every alpha and channel value and
+// measures their speed. Runs without a window, returns non-zero on errors.
+
+namespace {
+
+constexpr auto kBenchmarkWidth = 1024;
+constexpr auto kBenchmarkHeight = 1024;
+constexpr auto kBenchmarkRuns = 64;
+
+// Some extra pixels, so that vector kernels process a scalar tail.
+constexpr auto kTail = 7;
+
+[[nodiscard]] uint Color(int alpha, int value) {
+	// Every channel gets every value, in a different order.
+	return (uint(alpha) << 24)
+		| (uint(value) << 16)
+		| (uint((value + 85) & 0xFF) << 8)
+		| uint((value + 170) & 0xFF);
+}
+
+[[nodiscard]] std::vector<uint> AllStraight() {
+	auto result = std::vector<uint>();
+	result.reserve(256 * 256 + kTail);
+	for (auto alpha = 0; alpha != 256; ++alpha) {
+		for (auto value = 0; value != 256; ++value) {
+			result.push_back(Color(alpha, value));
+		}
+	}
+	for (auto i = 0; i != kTail; ++i) {
+		result.push_back(Color(i * 37, i * 53));
+	}
+	return result;
+}
+
+[[nodiscard]] std::vector<uint> AllPremultiplied() {
+	// Only valid premultiplied pixels, no channel is above alpha.
+	auto result = std::vector<uint>();
+	result.reserve(256 * 257 / 2 + kTail);
+	for (auto alpha = 0; alpha != 256; ++alpha) {
+		for (auto value = 0; value <= alpha; ++value) {
+			result.push_back((uint(alpha) << 24)
+				| (uint(value) << 16)
+				| (uint(alpha - value) << 8)
+				| uint(value / 2));
+		}
+	}
+	for (auto i = 0; i != kTail; ++i) {
+		result.push_back(qPremultiply(Color(i * 37, i * 53)));
+	}
+	return result;
+}
+
+[[nodiscard]] QImage Wrap(std::vector<uint> &pixels) {
+	return QImage(
+		reinterpret_cast<uchar*>(pixels.data()),
+		int(pixels.size()),
+		1,
+		int(pixels.size() * sizeof(uint)),
+		QImage::Format_ARGB32);
+}
+
+[[nodiscard]] int Report(
+		const char *name,
+		uint source,
+		uint result,
+		uint expected) {
+	std::printf(
+		"%s FAILED: %08X -> %08X, expected %08X.\n",
+		name,
+		source,
+		result,
+		expected);
+	return 1;
+}
+
+[[nodiscard]] int CheckPremultiply() {
+	auto source = AllStraight();
+	auto pixels = source;
+	auto image = Wrap(pixels);
+	FFmpeg::PremultiplyInplace(image);
+	for (auto i = 0; i != int(source.size()); ++i) {
+		const auto expected = qPremultiply(source[i]);
+		if (pixels[i] != expected) {
+			return Report("Premultiply", source[i], pixels[i], expected);
+		}
+	}
+	std::printf("Premultiply: %d pixels OK.\n", int(source.size()));
+	return 0;
+}
+
+[[nodiscard]] int CheckUnPremultiply() {
+	auto source = AllPremultiplied();
+	const auto image = Wrap(source);
+	auto result = QImage();
+	FFmpeg::UnPremultiply(result, image);
+	const auto pixels = reinterpret_cast<const uint*>(result.constBits());
+	for (auto i = 0; i != int(source.size()); ++i) {
+		const auto expected = qUnpremultiply(source[i]);
+		if (pixels[i] != expected) {
+			return Report("UnPremultiply", source[i], pixels[i], expected);
+		}
+	}
+	std::printf("UnPremultiply: %d pixels OK.\n", int(source.size()));
+	return 0;
+}
+
+[[nodiscard]] int CheckPadded() {
+	// Lines with padding are processed one by one.
+	constexpr auto kWidth = 13;
+	constexpr auto kHeight = 16;
+	constexpr auto kPerLine = 16;
+	auto source = std::vector<uint>(kPerLine * kHeight);
+	for (auto i = 0; i != int(source.size()); ++i) {
+		source[i] = Color((i * 29) & 0xFF, (i * 71) & 0xFF);
+	}
+	auto pixels = source;
+	auto image = QImage(
+		reinterpret_cast<uchar*>(pixels.data()),
+		kWidth,
+		kHeight,
+		kPerLine * sizeof(uint),
+		QImage::Format_ARGB32);
+	FFmpeg::PremultiplyInplace(image);
+	for (auto y = 0; y != kHeight; ++y) {
+		for (auto x = 0; x != kPerLine; ++x) {
+			const auto i = y * kPerLine + x;
+			const auto expected = (x < kWidth)
+				? qPremultiply(source[i])
+				: source[i];
+			if (pixels[i] != expected) {
+				return Report("Padded", source[i], pixels[i], expected);
+			}
+		}
+	}
+	std::printf("Padded: %d lines OK.\n", kHeight);
+	return 0;
+}
+
+void Benchmark() {
+	const auto count = kBenchmarkWidth * kBenchmarkHeight;
+	auto straight = std::vector<uint>(count);
+	for (auto i = 0; i != count; ++i) {
+		// Mostly opaque and transparent pixels, as in stickers.
+		const auto alpha = (i % 16 == 0) ? ((i / 16) & 0xFF) : (i & 1) * 255;
+		straight[i] = Color(alpha, (i * 71) & 0xFF);
+	}
+	const auto megapixels = double(count) * kBenchmarkRuns / 1'000'000.;
+	const auto print = [&](const char *name, qint64 ns) {
+		std::printf(
+			"%s: %.1f MPix/s.\n",
+			name,
+			megapixels * 1'000'000'000. / std::max(ns, qint64(1)));
+	};
+
+	auto timer = QElapsedTimer();
+	auto work = straight;
+	auto image = QImage(
+		reinterpret_cast<uchar*>(work.data()),
+		kBenchmarkWidth,
+		kBenchmarkHeight,
+		QImage::Format_ARGB32);
+	auto premultiplyNs = qint64();
+	for (auto i = 0; i != kBenchmarkRuns; ++i) {
+		work = straight;
+		timer.start();
+		FFmpeg::PremultiplyInplace(image);
+		premultiplyNs += timer.nsecsElapsed();
+	}
+	print("Premultiply", premultiplyNs);
+
+	auto result = QImage();
+	timer.start();
+	for (auto i = 0; i != kBenchmarkRuns; ++i) {
+		FFmpeg::UnPremultiply(result, image);
+	}
+	print("UnPremultiply", timer.nsecsElapsed());
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	const auto failed = CheckPremultiply()
+		+ CheckUnPremultiply()
+		+ CheckPadded();
+	if (failed) {
+		return 1;
+	}
+	Benchmark();
+	return 0;
+}
@@ -27,6 +27,7 @@ constexpr auto kCacheBackgroundFastTimeout = crl::time(200);
 constexpr auto kBackgroundFadeDuration = crl::time(200);
 constexpr auto kMinimumTiledSize = 512;
 constexpr auto kMaxSize = 2960;
+constexpr auto kCachedBackgroundSizes = 3;
 constexpr auto kMaxContrastValue = 21.;
 constexpr auto kMinAcceptableContrast = 1.14;// 4.5;
 
@@ -405,6 +406,7 @@ void ChatTheme::setBackground(ChatThemeBackground &&background) {
 	_mutableBackground = std::move(background);
 	_backgroundState = {};
 	_backgroundNext = {};
+	_backgroundSizes.clear();
 	_backgroundFade.stop();
 	if (_cacheBackgroundTimer) {
 		_cacheBackgroundTimer->cancel();
@@ -417,6 +419,7 @@ void ChatTheme::updateBackgroundImageFrom(ChatThemeBackground &&background) {
 	_mutableBackground.prepared = std::move(background.prepared);
 	_mutableBackground.preparedForTiled = std::move(
 		background.preparedForTiled);
+	_backgroundSizes.clear();
 	if (!_backgroundState.now.pixmap.isNull()) {
 		if (_cacheBackgroundTimer) {
 			_cacheBackgroundTimer->cancel();
@@ -499,12 +502,18 @@ const BackgroundState &ChatTheme::backgroundState(QSize area) {
 		_cacheBackgroundTimer.emplace([=] { cacheBackground(); });
 	}
 	_backgroundState.shown = _backgroundFade.value(1.);
-	if (_backgroundState.now.pixmap.isNull()
+	if (_backgroundState.now.area != area
+		&& useCachedBackgroundSize(area)) {
+		_cacheBackgroundArea = area;
+		_cacheBackgroundTimer->cancel();
+	} else if (_backgroundState.now.pixmap.isNull()
 		&& !background().gradientForFill.isNull()) {
 		// We don't support direct painting of patterned gradients.
 		// So we need to sync-generate cache image here.
 		_cacheBackgroundArea = area;
-		setCachedBackground(CacheBackground(cacheBackgroundRequest(area)));
+		const auto request = cacheBackgroundRequest(area);
+		setCachedBackground(CacheBackground(request));
+		rememberBackgroundSize(request);
 		_cacheBackgroundTimer->cancel();
 	} else if (_backgroundState.now.area != area) {
 		if (_cacheBackgroundArea != area
@@ -522,6 +531,7 @@ const BackgroundState &ChatTheme::backgroundState(QSize area) {
 void ChatTheme::clearBackgroundState() {
 	_backgroundState = BackgroundState();
 	_backgroundFade.stop();
+	_backgroundSizes.clear();
 }
 
 bool ChatTheme::readyForBackgroundRotation() const {
@@ -597,6 +607,51 @@ void ChatTheme::cacheBackgroundNow() {
 	}
 }
 
+bool ChatTheme::useCachedBackgroundSize(QSize area) {
+	const auto request = cacheBackgroundRequest(area);
+	if (!request) {
+		return false;
+	}
+	const auto i = ranges::find_if(_backgroundSizes, [&](
+			const CachedBackgroundSize &entry) {
+		return (entry.request == request)
+			&& (entry.request.background.gradientRotation
+				== request.background.gradientRotation);
+	});
+	if (i == end(_backgroundSizes)) {
+		return false;
+	}
+	std::rotate(begin(_backgroundSizes), i, i + 1);
+	_backgroundFade.stop();
+	_backgroundNext = {};
+	_backgroundState.was = {};
+	_backgroundState.now = _backgroundSizes.front().cached;
+	_backgroundState.shown = 1.;
+	return true;
+}
+
+void ChatTheme::rememberBackgroundSize(
+		const CacheBackgroundRequest &request) {
+	const auto &now = _backgroundState.now;
+	if (now.pixmap.isNull() || now.waitingForNegativePattern) {
+		return;
+	}
+	_backgroundSizes.erase(
+		ranges::remove(
+			_backgroundSizes,
+			request.area,
+			[](const CachedBackgroundSize &entry) {
+				return entry.request.area;
+			}),
+		end(_backgroundSizes));
+	_backgroundSizes.insert(
+		begin(_backgroundSizes),
+		CachedBackgroundSize{ request, now });
+	if (_backgroundSizes.size() > kCachedBackgroundSizes) {
+		_backgroundSizes.pop_back();
+	}
+}
+
 void ChatTheme::cacheBackgroundAsync(
 		const CacheBackgroundRequest &request,
 		Fn<void(CacheBackgroundResult&&)> done) {
@@ -612,10 +667,14 @@ void ChatTheme::cacheBackgroundAsync(
 			} else if (const auto request = cacheBackgroundRequest(
 					_cacheBackgroundArea)) {
 				if (_backgroundCachingRequest != request) {
-					cacheBackgroundAsync(request);
+					_backgroundCachingRequest = {};
+					if (!useCachedBackgroundSize(_cacheBackgroundArea)) {
+						cacheBackgroundAsync(request);
+					}
 				} else {
 					_backgroundCachingRequest = {};
 					setCachedBackground(std::move(result));
+					rememberBackgroundSize(request);
 				}
 			}
 		});
@@ -720,6 +779,7 @@ void ChatTheme::rotateComplexGradientBackground() {
 			_mutableBackground.gradientForFill
 				= std::move(_backgroundNext.gradient);
 		}
+		_backgroundSizes.clear();
 		setCachedBackground(base::take(_backgroundNext));
 	}
 }
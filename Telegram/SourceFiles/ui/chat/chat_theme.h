@@ -171,8 +171,15 @@ public:
 		int addRotation = 0) const;
 
 private:
+	struct CachedBackgroundSize {
+		CacheBackgroundRequest request;
+		CachedBackground cached;
+	};
+
 	void cacheBackground();
 	void cacheBackgroundNow();
+	[[nodiscard]] bool useCachedBackgroundSize(QSize area);
+	void rememberBackgroundSize(const CacheBackgroundRequest &request);
 	void cacheBackgroundAsync(
 		const CacheBackgroundRequest &request,
 		Fn<void(CacheBackgroundResult&&)> done = nullptr);
@@ -204,6 +211,7 @@ private:
 	QSize _cacheBackgroundArea;
 	crl::time _lastBackgroundAreaChangeTime = 0;
 	std::optional<base::Timer> _cacheBackgroundTimer;
+	std::vector<CachedBackgroundSize> _backgroundSizes;
 
 	CachedBackground _bubblesBackground;
 	QImage _bubblesBackgroundPrepared;
@@ -38,6 +38,9 @@ constexpr auto kFadeDuration = crl::time(150);
 constexpr auto kSkipFrames = 8;
 constexpr auto kMinScale = 0.7;
 
+// Frames waiting for the encoder, the newer ones are dropped after that.
+constexpr auto kMaxQueuedFrames = 2;
+
 using namespace FFmpeg;
 
 struct ReadBytesWrap {
@@ -73,6 +76,23 @@ struct ReadBytesWrap {
 	};
 };
 
+[[nodiscard]] QImage CropSquare(const QImage &original) {
+	const auto owidth = original.width();
+	const auto oheight = original.height();
+	const auto omin = std::min(owidth, oheight);
+	const auto ox = (owidth > oheight) ? (owidth - oheight) / 2 : 0;
+	const auto oy = (owidth < oheight) ? (oheight - owidth) / 2 : 0;
+	const auto bytesPerLine = original.bytesPerLine();
+	const auto depth = original.depth() / 8;
+	const auto shift = (bytesPerLine * oy) + (ox * depth);
+	return QImage(
+		original.constBits() + shift,
+		omin,
+		omin,
+		bytesPerLine,
+		original.format());
+}
+
 [[nodiscard]] int MinithumbSize() {
 	const auto full = st::historySendSize.height();
 	const auto margin = st::historyRecordWaveformBgMargins;
@@ -205,6 +225,9 @@ private:
 	crl::time _maxDuration = 0;
 	RoundVideoResult _previous;
 
+	int _videoFramesEncoded = 0;
+	crl::time _videoEncodeDuration = 0;
+
 	ReadBytesWrap _forConcat1, _forConcat2;
 
 	std::vector<bool> _circleMask; // Always nice to use vector<bool>! :D
@@ -486,6 +509,11 @@ RoundVideoResult RoundVideoRecorder::Private::finish() {
 		return {};
 	}
 	finishEncoding();
+	if (const auto encoded = base::take(_videoFramesEncoded)) {
+		DEBUG_LOG(("Round Video: %1 frames encoded, %2 ms per frame."
+			).arg(encoded
+			).arg(base::take(_videoEncodeDuration) / float64(encoded)));
+	}
 	auto result = appendToPrevious({
 		.content = base::take(_result),
 		.duration = base::take(_resultDuration),
@@ -702,7 +730,10 @@ void RoundVideoRecorder::Private::push(
 	} else if (!_firstVideoFrameTime) {
 		_firstVideoFrameTime = crl::now();
 	}
+	const auto started = crl::now();
 	encodeVideoFrame(mcstimestamp, frame);
+	_videoEncodeDuration += crl::now() - started;
+	++_videoFramesEncoded;
 }
 
 void RoundVideoRecorder::Private::push(const Media::Capture::Chunk &chunk) {
@@ -1062,7 +1093,8 @@ RoundVideoRecorder::RoundVideoRecorder(
 	_gradientFg.color(),
 	[=] { _preview->update(); })
 , _preview(std::make_unique<RpWidget>(_descriptor.container))
-, _private(MinithumbSize()) {
+, _private(MinithumbSize())
+, _framesQueued(std::make_shared<std::atomic<int>>(0)) {
 	setup();
 }
 
@@ -1136,50 +1168,56 @@ void RoundVideoRecorder::preparePlaceholder(const QImage &placeholder) {
 	_framePlaceholder.setDevicePixelRatio(ratio);
 }
 
-void RoundVideoRecorder::prepareFrame(bool blurred) {
-	if (_frameOriginal.isNull()) {
+void RoundVideoRecorder::pushFrame(int64 mcstimestamp, const QImage &frame) {
+	// Encoding is slower than the camera, keep the recording real-time.
+	if (_framesQueued->load() >= kMaxQueuedFrames) {
+		++_framesDropped;
 		return;
-	} else if (!blurred) {
-		if (_preparedIndex == _lastAddedIndex) {
-			return;
-		}
-		_preparedIndex = _lastAddedIndex;
 	}
+	++*_framesQueued;
+	_private.with([=, queued = _framesQueued](Private &that) {
+		that.push(mcstimestamp, frame);
+		--*queued;
+	});
+}
 
-	const auto owidth = _frameOriginal.width();
-	const auto oheight = _frameOriginal.height();
-	const auto omin = std::min(owidth, oheight);
-	const auto ox = (owidth > oheight) ? (owidth - oheight) / 2 : 0;
-	const auto oy = (owidth < oheight) ? (oheight - owidth) / 2 : 0;
-	const auto from = QRect(ox, oy, omin, omin);
-	const auto bytesPerLine = _frameOriginal.bytesPerLine();
-	const auto depth = _frameOriginal.depth() / 8;
-	const auto shift = (bytesPerLine * from.y()) + (from.x() * depth);
-	auto copy = QImage(
-		_frameOriginal.constBits() + shift,
-		omin, omin,
-		bytesPerLine,
-		_frameOriginal.format());
-
-	const auto ratio = style::DevicePixelRatio();
-	if (blurred) {
+void RoundVideoRecorder::prepareFrame(bool blurred) {
+	if (_frameOriginal.isNull()) {
+		return;
+	} else if (blurred) {
 		static constexpr auto kRadius = 16;
 		auto image = Images::BlurLargeImage(
-			copy.scaled(
+			CropSquare(_frameOriginal).scaled(
 				QSize(kBlurredSize, kBlurredSize),
 				Qt::KeepAspectRatio,
 				Qt::FastTransformation),
 			kRadius).mirrored(true, false);
 		preparePlaceholder(image);
 		_placeholderUpdates.fire(std::move(image));
-	} else {
-		auto scaled = copy.scaled(
-			QSize(_side, _side) * ratio,
+		return;
+	} else if (_framePreparing || _preparedIndex == _lastAddedIndex) {
+		return;
+	}
+	_preparedIndex = _lastAddedIndex;
+	_framePreparing = true;
+
+	const auto ratio = style::DevicePixelRatio();
+	const auto size = QSize(_side, _side) * ratio;
+	const auto weak = base::make_weak(this);
+	crl::async([=, original = _frameOriginal] {
+		auto scaled = CropSquare(original).scaled(
+			size,
 			Qt::KeepAspectRatio,
 			Qt::SmoothTransformation).mirrored(true, false);
-		_framePrepared = Images::Circle(std::move(scaled));
-		_framePrepared.setDevicePixelRatio(ratio);
-	}
+		auto prepared = Images::Circle(std::move(scaled));
+		prepared.setDevicePixelRatio(ratio);
+		crl::on_main(weak, [=, prepared = std::move(prepared)]() mutable {
+			_framePreparing = false;
+			_framePrepared = std::move(prepared);
+			_preview->update();
+			prepareFrame();
+		});
+	});
 }
 
 void RoundVideoRecorder::createImages() {
@@ -1263,8 +1301,6 @@ void RoundVideoRecorder::setup() {
 	};
 
 	raw->paintRequest() | rpl::start_with_next([=] {
-		prepareFrame();
-
 		auto p = QPainter(raw);
 		const auto faded = _fadeAnimation.value(_visible ? 1. : 0.);
 		if (_fadeAnimation.animating()) {
@@ -1347,14 +1383,11 @@ void RoundVideoRecorder::setup() {
 				--_skipFrames;
 			} else {
 				_frameOriginal = info.original;
-				const auto ts = info.mcstimestamp;
-				_private.with([copy = info.original, ts](Private &that) {
-					that.push(ts, copy);
-				});
+				pushFrame(info.mcstimestamp, info.original);
+				prepareFrame();
 			}
 		}
 		_descriptor.track->markFrameShown();
-		raw->update();
 	}, raw->lifetime());
 	_descriptor.track->markFrameShown();
 
@@ -1409,6 +1442,9 @@ void RoundVideoRecorder::pause(Fn<void(RoundVideoResult)> done) {
 		});
 	}
 	_paused = true;
+	if (const auto dropped = base::take(_framesDropped)) {
+		DEBUG_LOG(("Round Video: %1 frames dropped.").arg(dropped));
+	}
 	prepareFrame(true);
 	_progressReceived = false;
 	_fadeContentAnimation.start(updater(), 1., 0., kFadeDuration);
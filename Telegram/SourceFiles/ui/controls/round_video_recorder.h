@@ -13,6 +13,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <crl/crl_object_on_queue.h>
 
+#include <atomic>
+
 namespace Media::Capture {
 struct Chunk;
 struct Update;
@@ -86,6 +88,7 @@ private:
 	};
 
 	void setup();
+	void pushFrame(int64 mcstimestamp, const QImage &frame);
 	void prepareFrame(bool blurred = false);
 	void preparePlaceholder(const QImage &placeholder);
 	void createImages();
@@ -116,6 +119,8 @@ private:
 	QImage _framePlaceholder;
 	QImage _framePrepared;
 	QImage _shadow;
+	const std::shared_ptr<std::atomic<int>> _framesQueued;
+	int _framesDropped = 0;
 	int _lastAddedIndex = 0;
 	int _preparedIndex = 0;
 	int _side = 0;
@@ -123,6 +128,7 @@ private:
 	int _extent = 0;
 	int _skipFrames = 0;
 	bool _progressReceived = false;
+	bool _framePreparing = false;
 	bool _visible = false;
 	bool _paused = false;
 
@@ -12,11 +12,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "ui/ui_utility.h"
 
+#include <QtCore/QBuffer>
+#include <QtGui/QImageReader>
+
 using namespace Images;
 
 namespace Images {
 namespace {
 
+// Not above the area limit of Images::Read().
+constexpr auto kMaxDownscaledArea = int64(4096) * 4096;
+
 [[nodiscard]] uint64 PixKey(int width, int height, Options options) {
 	return static_cast<uint64>(width)
 		| (static_cast<uint64>(height) << 24)
@@ -41,6 +47,57 @@ namespace {
 
 } // namespace
 
+QImage ReadDownscaled(
+		const QByteArray &content,
+		QSize box,
+		QByteArray *format) {
+	const auto fallback = [&] {
+		auto read = Read({ .content = content });
+		if (format) {
+			*format = read.format;
+		}
+		return std::move(read.image);
+	};
+	if (box.isEmpty() || content.isEmpty()) {
+		return fallback();
+	}
+	auto bytes = content;
+	auto buffer = QBuffer(&bytes);
+	auto reader = QImageReader(&buffer);
+	reader.setAutoTransform(true);
+
+	// Only take the short path for what Read() surely accepts as is,
+	// everything else goes through Read() and its own checks.
+	const auto size = reader.size();
+	if (!reader.canRead()
+		|| !size.isValid()
+		|| size.isEmpty()
+		|| (int64(size.width()) * size.height() > kMaxDownscaledArea)
+		|| !reader.supportsOption(QImageIOHandler::ScaledSize)
+		|| (reader.supportsAnimation() && reader.imageCount() > 1)) {
+		return fallback();
+	}
+	// Scaled size is applied before the EXIF orientation transform.
+	const auto rotated = (reader.transformation()
+		& QImageIOHandler::TransformationRotate90);
+	const auto fit = rotated ? box.transposed() : box;
+	if (size.width() <= fit.width() && size.height() <= fit.height()) {
+		return fallback();
+	}
+	reader.setScaledSize(size.scaled(fit, Qt::KeepAspectRatio));
+	const auto readFormat = reader.format();
+	auto result = reader.read();
+	if (result.isNull()) {
+		return fallback();
+	} else if (format) {
+		*format = readFormat;
+	}
+	return (result.format() == QImage::Format_ARGB32_Premultiplied)
+		? result
+		: std::move(result).convertToFormat(
+			QImage::Format_ARGB32_Premultiplied);
+}
+
 } // namespace Images
 
 Image::Image(const QString &path)
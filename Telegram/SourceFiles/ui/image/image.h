@@ -102,3 +102,16 @@ private:
 	mutable base::flat_map<uint64, QPixmap> _cache;
 
 };
+
+namespace Images {
+
+// Reads the image right into the size that fits the box, so that codecs
+// supporting it (libjpeg scaled IDCT, libwebp scaling) skip the full
+// resolution decode. Empty box, animated, very large or unsupported
+// images are read by Read(), with its validation.
+[[nodiscard]] QImage ReadDownscaled(
+	const QByteArray &content,
+	QSize box,
+	QByteArray *format = nullptr);
+
+} // namespace Images
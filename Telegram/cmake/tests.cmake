@@ -42,3 +42,24 @@ set_target_properties(test_text PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINA
 add_dependencies(Telegram test_text)
 
 target_prepare_qrc(test_text)
+
+add_executable(test_premultiply)
+init_target(test_premultiply "(tests)")
+
+target_include_directories(test_premultiply PRIVATE ${src_loc})
+
+nice_target_sources(test_premultiply ${src_loc}
+PRIVATE
+    tests/test_premultiply.cpp
+)
+
+target_link_libraries(test_premultiply
+PRIVATE
+    desktop-app::lib_base
+    desktop-app::lib_ffmpeg
+    desktop-app::external_qt
+)
+
+set_target_properties(test_premultiply PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR})
+
+add_dependencies(Telegram test_premultiply)